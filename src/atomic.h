@@ -0,0 +1,52 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+#ifndef JALV_ATOMIC_H
+#define JALV_ATOMIC_H
+
+/*
+  Minimal atomic operations for flags and counters shared with the process
+  thread.  These are only used for naturally aligned scalars and pointers, so
+  the compiler builtins are lock-free on every supported platform.
+*/
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#  define JALV_ATOMIC_LOAD(ptr) \
+    (_ReadWriteBarrier(), *(volatile const long*)(ptr))
+#  define JALV_ATOMIC_STORE(ptr, val) \
+    do {                              \
+      _ReadWriteBarrier();            \
+      *(volatile long*)(ptr) = (val); \
+    } while (0)
+#  define JALV_ATOMIC_ADD(ptr, val) \
+    _InterlockedExchangeAdd((volatile long*)(ptr), (long)(val))
+#  define JALV_ATOMIC_EXCHANGE(ptr, val) \
+    _InterlockedExchange((volatile long*)(ptr), (long)(val))
+#  define JALV_ATOMIC_OR(ptr, val) \
+    _InterlockedOr((volatile long*)(ptr), (long)(val))
+#  define JALV_ATOMIC_LOAD_PTR(ptr) \
+    (_ReadWriteBarrier(), *(void* volatile const*)(ptr))
+#  define JALV_ATOMIC_STORE_PTR(ptr, val) \
+    do {                                  \
+      _ReadWriteBarrier();                \
+      *(void* volatile*)(ptr) = (val);    \
+    } while (0)
+#  define JALV_FENCE() _ReadWriteBarrier()
+#else
+#  define JALV_ATOMIC_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#  define JALV_ATOMIC_STORE(ptr, val) \
+    __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#  define JALV_ATOMIC_ADD(ptr, val) \
+    __atomic_fetch_add((ptr), (val), __ATOMIC_ACQ_REL)
+#  define JALV_ATOMIC_EXCHANGE(ptr, val) \
+    __atomic_exchange_n((ptr), (val), __ATOMIC_ACQ_REL)
+#  define JALV_ATOMIC_OR(ptr, val) \
+    __atomic_fetch_or((ptr), (val), __ATOMIC_ACQ_REL)
+#  define JALV_ATOMIC_LOAD_PTR(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#  define JALV_ATOMIC_STORE_PTR(ptr, val) \
+    __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#  define JALV_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+#endif // JALV_ATOMIC_H
@@ -7,7 +7,9 @@
 #include "attributes.h"
 #include "types.h"
 
+#include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 
 JALV_BEGIN_DECLS
 
@@ -33,6 +35,25 @@ jalv_backend_close(Jalv* jalv);
 void
 jalv_backend_activate_port(Jalv* jalv, uint32_t port_index);
 
+/**
+   Set the gain of one source of a mixed audio input.
+
+   @return Zero on success, or non-zero if the port has no such source.
+*/
+int
+jalv_backend_set_input_gain(Jalv*    jalv,
+                            uint32_t port_index,
+                            uint32_t source,
+                            float    gain);
+
+/// Return true iff a control port has its own audio input for modulation
+bool
+jalv_backend_has_control_input(Jalv* jalv, uint32_t port_index);
+
+/// Print processing statistics
+void
+jalv_backend_print_stats(Jalv* jalv, FILE* stream);
+
 JALV_END_DECLS
 
 #endif // JALV_BACKEND_H
@@ -0,0 +1,50 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+#ifndef JALV_CLOCK_H
+#define JALV_CLOCK_H
+
+#include "attributes.h"
+#include "jalv_config.h"
+
+#if USE_CLOCK_GETTIME
+#  include <time.h>
+#elif defined(_WIN32)
+#  include <windows.h>
+#else
+#  include <sys/time.h>
+#endif
+
+#include <stdint.h>
+
+JALV_BEGIN_DECLS
+
+/**
+   Return the current time of a monotonic clock in nanoseconds.
+
+   This is realtime safe, and intended for measuring durations in the process
+   thread.  The epoch is arbitrary, so only differences are meaningful.
+*/
+static inline uint64_t
+jalv_clock_now(void)
+{
+#if USE_CLOCK_GETTIME
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+#elif defined(_WIN32)
+  LARGE_INTEGER freq;
+  LARGE_INTEGER count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (uint64_t)((double)count.QuadPart * 1.0e9 / (double)freq.QuadPart);
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000000U + (uint64_t)tv.tv_usec * 1000U;
+#endif
+}
+
+JALV_END_DECLS
+
+#endif // JALV_CLOCK_H
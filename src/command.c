@@ -0,0 +1,489 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+#include "command.h"
+
+#include "atomic.h"
+#include "backend.h"
+#include "clock.h"
+#include "control.h"
+#include "jalv_internal.h"
+#include "meter.h"
+#include "modulator.h"
+#include "port.h"
+#include "ring.h"
+#include "scope.h"
+#include "watchdog.h"
+
+#include "lilv/lilv.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+void
+jalv_print_host_commands(FILE* const stream)
+{
+  fprintf(stream,
+          "  begin             Begin a batch of control values\n"
+          "  commit            Apply all values in the batch at once\n"
+          "  abort             Discard all values in the batch\n"
+          "  bypass on|off     Bypass plugin (with latency compensation)\n"
+          "  levels            Print audio levels (with -R)\n"
+          "  mix SYMBOL N GAIN Set gain of source N of a mixed input\n"
+          "  mod TYPE SYM ...  Modulate a control (lfo, ramp, env, input)\n"
+          "  mod off SYMBOL    Remove the modulator of a control\n"
+          "  mods              Print modulators as commands\n"
+          "  ring in|out BYTES Resize the ring of events to or from the UI\n"
+          "  scope SYMBOL      Print captured frames of a port (with -T)\n"
+          "  stats             Print processing statistics\n"
+          "  watchdog          Print overrun watchdog status (with -W)\n");
+}
+
+static const char* const jalv_lfo_shape_names[] = {
+  "sine", "triangle", "saw", "square"};
+
+static const char* const jalv_reduction_names[] = {"mean", "peak", "last"};
+
+/// Return the index of `name` in the first `n_names` names, or -1
+static int
+jalv_find_name(const char* const* const names,
+               const unsigned           n_names,
+               const char* const        name)
+{
+  for (unsigned i = 0U; i < n_names; ++i) {
+    if (!strcmp(name, names[i])) {
+      return (int)i;
+    }
+  }
+
+  return -1;
+}
+
+static const char*
+jalv_port_symbol(const Jalv* const jalv, const uint32_t port_index)
+{
+  return lilv_node_as_string(
+    lilv_port_get_symbol(jalv->plugin, jalv->ports[port_index].lilv_port));
+}
+
+void
+jalv_write_modulators(Jalv* const jalv, FILE* const stream)
+{
+  for (uint32_t i = 0U; i < JALV_MAX_MODULATORS; ++i) {
+    const JalvModSettings* const s = jalv_modulators_get(jalv->modulators, i);
+    if (!s) {
+      continue;
+    }
+
+    const char* const target = jalv_port_symbol(jalv, s->target);
+    switch (s->type) {
+    case JALV_MOD_LFO:
+      fprintf(stream,
+              "mod lfo %s %.9g %.9g %.9g %s\n",
+              target,
+              (double)s->time,
+              (double)s->depth,
+              (double)s->offset,
+              jalv_lfo_shape_names[s->shape]);
+      break;
+    case JALV_MOD_RAMP:
+      fprintf(stream,
+              "mod ramp %s %.9g %.9g %.9g\n",
+              target,
+              (double)s->time,
+              (double)s->depth,
+              (double)s->offset);
+      break;
+    case JALV_MOD_ENVELOPE:
+      fprintf(stream,
+              "mod env %s %s %.9g %.9g %.9g %.9g\n",
+              target,
+              jalv_port_symbol(jalv, s->source),
+              (double)s->time,
+              (double)s->release,
+              (double)s->depth,
+              (double)s->offset);
+      break;
+    case JALV_MOD_INPUT:
+      fprintf(stream,
+              "mod input %s %s %.9g %.9g %.9g\n",
+              target,
+              jalv_reduction_names[s->reduction],
+              (double)s->time,
+              (double)s->depth,
+              (double)s->offset);
+      break;
+    }
+  }
+}
+
+/// Process a "mod" command to set or remove the modulator of a control
+static void
+jalv_process_mod_command(Jalv* const jalv, const char* const args)
+{
+  char            sym[1024];
+  char            arg[1024];
+  JalvModSettings s;
+  int             n = 0;
+
+  memset(&s, 0, sizeof(s));
+  if (sscanf(args, "off %1023[a-zA-Z0-9_]", sym) == 1) {
+    const ControlID* const control = jalv_control_by_symbol(jalv, sym);
+    if (!control || control->type != PORT ||
+        !jalv_modulators_clear(jalv->modulators, control->index)) {
+      fprintf(stderr, "error: control `%s' is not modulated\n", sym);
+    }
+    return;
+  }
+
+  if ((n = sscanf(args,
+                  "lfo %1023[a-zA-Z0-9_] %f %f %f %1023s",
+                  sym,
+                  &s.time,
+                  &s.depth,
+                  &s.offset,
+                  arg)) >= 3) {
+    s.type   = JALV_MOD_LFO;
+    s.offset = n >= 4 ? s.offset : 0.5f;
+    const int shape = n == 5 ? jalv_find_name(jalv_lfo_shape_names, 4U, arg)
+                             : (int)JALV_LFO_SINE;
+    if (shape < 0) {
+      fprintf(stderr, "error: unknown LFO shape `%s'\n", arg);
+      return;
+    }
+
+    s.shape = (JalvLfoShape)shape;
+  } else if ((n = sscanf(args,
+                         "ramp %1023[a-zA-Z0-9_] %f %f %f",
+                         sym,
+                         &s.time,
+                         &s.depth,
+                         &s.offset)) >= 3) {
+    s.type   = JALV_MOD_RAMP;
+    s.offset = n >= 4 ? s.offset : 0.0f;
+  } else if ((n = sscanf(args,
+                         "env %1023[a-zA-Z0-9_] %1023[a-zA-Z0-9_] %f %f %f %f",
+                         sym,
+                         arg,
+                         &s.time,
+                         &s.release,
+                         &s.depth,
+                         &s.offset)) >= 5) {
+    const struct Port* const input = jalv_port_by_symbol(jalv, arg);
+    if (!input || input->flow != FLOW_INPUT ||
+        (input->type != TYPE_AUDIO && input->type != TYPE_CV)) {
+      fprintf(stderr, "error: no audio input `%s'\n", arg);
+      return;
+    }
+
+    s.type   = JALV_MOD_ENVELOPE;
+    s.source = input->index;
+    s.offset = n >= 6 ? s.offset : 0.0f;
+  } else if ((n = sscanf(args,
+                         "input %1023[a-zA-Z0-9_] %1023s %f %f %f",
+                         sym,
+                         arg,
+                         &s.time,
+                         &s.depth,
+                         &s.offset)) >= 1) {
+    s.type  = JALV_MOD_INPUT;
+    s.depth = n >= 4 ? s.depth : 1.0f;
+    const int reduction = n >= 2
+                            ? jalv_find_name(jalv_reduction_names, 3U, arg)
+                            : (int)JALV_REDUCE_MEAN;
+    if (reduction < 0) {
+      fprintf(stderr, "error: unknown reduction `%s'\n", arg);
+      return;
+    }
+
+    s.reduction = (JalvReduction)reduction;
+  } else {
+    fprintf(stderr, "error: invalid modulator `%s'\n", args);
+    return;
+  }
+
+  const ControlID* const control = jalv_control_by_symbol(jalv, sym);
+  if (!control || control->type != PORT || !control->is_writable) {
+    fprintf(stderr, "error: no control input `%s'\n", sym);
+    return;
+  }
+
+  if (s.type == JALV_MOD_INPUT &&
+      !jalv_backend_has_control_input(jalv, control->index)) {
+    fprintf(stderr, "error: control `%s' has no input (see -C)\n", sym);
+    return;
+  }
+
+  s.target = control->index;
+  s.min    = control->min ? lilv_node_as_float(control->min) : 0.0f;
+  s.max    = control->max ? lilv_node_as_float(control->max) : 1.0f;
+  if (jalv_modulators_set(
+        jalv->modulators, &s, &jalv->ports[control->index].control)) {
+    fprintf(stderr, "error: too many modulators\n");
+  }
+}
+
+static float
+jalv_level_db(const float level)
+{
+  return level > 0.0f ? 20.0f * log10f(level) : -INFINITY;
+}
+
+static void
+jalv_print_levels(Jalv* const jalv)
+{
+  if (!jalv->meters) {
+    fprintf(stderr, "error: metering is disabled\n");
+    return;
+  }
+
+  const JalvLevel* const levels = jalv_meters_read(jalv->meters, NULL);
+  for (uint32_t m = 0U; m < jalv_meters_count(jalv->meters); ++m) {
+    const struct Port* const port =
+      &jalv->ports[jalv_meters_port(jalv->meters, m)];
+
+    printf("%s: peak %.1f dB, RMS %.1f dB",
+           lilv_node_as_string(
+             lilv_port_get_symbol(jalv->plugin, port->lilv_port)),
+           (double)jalv_level_db(levels[m].peak),
+           (double)jalv_level_db(levels[m].rms));
+
+    if (!isnan(levels[m].loudness)) {
+      printf(", %.1f LUFS", (double)levels[m].loudness);
+    }
+
+    printf("\n");
+  }
+
+  fflush(stdout);
+}
+
+static void
+jalv_print_scope(Jalv* const jalv, const char* const sym)
+{
+  const struct Port* const port = jalv_port_by_symbol(jalv, sym);
+  for (uint32_t t = 0U; port && jalv->scope &&
+                        t < jalv_scope_n_taps(jalv->scope);
+       ++t) {
+    if (jalv_scope_port(jalv->scope, t) == port->index) {
+      const JalvScopeSnapshot* const snap = jalv_scope_read(jalv->scope, t);
+      const float* const data = snap->data + (snap->length - snap->n_frames);
+
+      printf("%s @ %" PRIu64 ":", sym, snap->frame);
+      for (uint32_t i = 0U; i < snap->n_frames; ++i) {
+        printf(" %g", (double)data[i]);
+      }
+
+      printf("\n");
+      fflush(stdout);
+      return;
+    }
+  }
+
+  fprintf(stderr, "error: no scope tap on `%s'\n", sym);
+}
+
+static void
+jalv_print_watchdog(Jalv* const jalv)
+{
+  if (!jalv->watchdog) {
+    fprintf(stderr, "error: watchdog is disabled\n");
+    return;
+  }
+
+  JalvWatchdogStatus status;
+  jalv_watchdog_status(jalv->watchdog, &status);
+
+  const uint64_t now = jalv_clock_now();
+  printf("Watchdog:     %s\n", status.tripped ? "tripped" : "running");
+  printf("Threshold:    %.0f%% of period for %u cycles\n",
+         status.threshold * 100.0,
+         status.trip_cycles);
+  printf("Last run:     %.3f ms\n", status.last_run / 1.0e6);
+  printf("Back-off:     %.1f s\n", status.backoff / 1.0e9);
+  printf("Trips:        %u", status.n_trips);
+  if (status.last_trip) {
+    printf(", last %.1f s ago", (now - status.last_trip) / 1.0e9);
+  }
+
+  printf("\n");
+  fflush(stdout);
+}
+
+static void
+jalv_print_ring(const char* const label, const JalvRing* const ring)
+{
+  JalvRingStats stats;
+  jalv_ring_stats(ring, &stats);
+  printf("%s %u of %u bytes max, %u dropped, %u resizes\n",
+         label,
+         stats.high_water,
+         stats.capacity,
+         stats.n_dropped,
+         stats.n_resizes);
+}
+
+/// Stage a control port value if a batch has begun, and return true if so
+static bool
+jalv_process_batch_set(Jalv* const jalv, const char* const cmd)
+{
+  char     sym[1024];
+  uint32_t index = 0U;
+  float    value = 0.0f;
+
+  if (sscanf(cmd, "set %u %f", &index, &value) == 2) {
+    if (jalv_batch_set(jalv, index, value)) {
+      fprintf(stderr, "error: failed to add port %u to batch\n", index);
+    }
+    return true;
+  }
+
+  if (sscanf(cmd, "set %1023[a-zA-Z0-9_] %f", sym, &value) == 2 ||
+      sscanf(cmd, "%1023[a-zA-Z0-9_] = %f", sym, &value) == 2) {
+    // Only plugin ports are batched, other controls are set immediately
+    const ControlID* const control = jalv_control_by_symbol(jalv, sym);
+    if (control && control->type == PORT) {
+      if (jalv_batch_set(jalv, control->index, value)) {
+        fprintf(stderr, "error: failed to add `%s' to batch\n", sym);
+      }
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool
+jalv_process_host_command(Jalv* const jalv, const char* const cmd)
+{
+  char     sym[1024];
+  uint32_t source = 0U;
+  float    value  = 0.0f;
+
+  if (!strcmp(cmd, "begin\n")) {
+    if (jalv_batch_begin(jalv)) {
+      fprintf(stderr, "error: batch has already begun\n");
+    }
+    return true;
+  }
+
+  if (!strcmp(cmd, "commit\n")) {
+    const uint32_t n_values = jalv->n_batch;
+    if (!jalv->batch) {
+      fprintf(stderr, "error: no batch to commit\n");
+    } else if (jalv_batch_commit(jalv)) {
+      fprintf(stderr, "error: failed to send batch\n");
+    } else {
+      jalv_log(JALV_LOG_INFO, "Committed %u values\n", n_values);
+    }
+    return true;
+  }
+
+  if (!strcmp(cmd, "abort\n")) {
+    jalv_batch_abort(jalv);
+    return true;
+  }
+
+  if (jalv->batch && jalv_process_batch_set(jalv, cmd)) {
+    return true;
+  }
+
+  if (!strcmp(cmd, "stats\n")) {
+    jalv_backend_print_stats(jalv, stdout);
+    printf("Pauses:       %u, %.2f ms last, %.2f ms max\n",
+           jalv->n_pauses,
+           jalv->pause_last / 1.0e6,
+           jalv->pause_max / 1.0e6);
+    printf("UI updates:   %u sent, %u unchanged\n",
+           (unsigned)JALV_ATOMIC_LOAD(&jalv->n_updates_sent),
+           (unsigned)JALV_ATOMIC_LOAD(&jalv->n_updates_kept));
+    printf("UI events:    %u last read, %u max, %u bytes max\n",
+           jalv->drain_last,
+           jalv->drain_max,
+           jalv->drain_bytes);
+    jalv_print_ring("UI priority: ", jalv->ui_priority);
+    jalv_print_ring("UI => Plugin:", jalv->ui_to_plugin);
+    jalv_print_ring("Plugin => UI:", jalv->plugin_to_ui);
+    fflush(stdout);
+    return true;
+  }
+
+  if (!strncmp(cmd, "mod ", 4)) {
+    jalv_process_mod_command(jalv, cmd + 4);
+    return true;
+  }
+
+  if (!strcmp(cmd, "mods\n")) {
+    jalv_write_modulators(jalv, stdout);
+    fflush(stdout);
+    return true;
+  }
+
+  if (sscanf(cmd, "ring %1023[a-z] %u", sym, &source) == 2) {
+    JalvRing* const ring = !strcmp(sym, "in")    ? jalv->ui_to_plugin
+                           : !strcmp(sym, "out") ? jalv->plugin_to_ui
+                                                 : NULL;
+    if (!ring) {
+      fprintf(stderr, "error: unknown ring `%s'\n", sym);
+    } else if (jalv_ring_resize(ring, source)) {
+      fprintf(stderr, "error: ring is still being resized\n");
+    }
+    return true;
+  }
+
+  if (!strcmp(cmd, "watchdog\n")) {
+    jalv_print_watchdog(jalv);
+    return true;
+  }
+
+  if (!strcmp(cmd, "levels\n")) {
+    jalv_print_levels(jalv);
+    return true;
+  }
+
+  if (sscanf(cmd, "scope %1023[a-zA-Z0-9_]", sym) == 1) {
+    jalv_print_scope(jalv, sym);
+    return true;
+  }
+
+  if (!strcmp(cmd, "bypass on\n") || !strcmp(cmd, "bypass off\n")) {
+    const ControlID* const control =
+      jalv_control_by_symbol(jalv, "jalv_bypass");
+    if (control) {
+      value = cmd[8] == 'n' ? 1.0f : 0.0f;
+      jalv_set_control(
+        jalv, control, sizeof(value), jalv->urids.atom_Float, &value);
+    } else {
+      fprintf(stderr, "error: plugin has no audio outputs to bypass\n");
+    }
+    return true;
+  }
+
+  if (sscanf(cmd, "mix %1023[a-zA-Z0-9_] %u %f", sym, &source, &value) == 3) {
+    const struct Port* const port = jalv_port_by_symbol(jalv, sym);
+    if (!port || source < 1U ||
+        jalv_backend_set_input_gain(jalv, port->index, source - 1U, value)) {
+      fprintf(
+        stderr, "error: no mixed input `%s' with source %u\n", sym, source);
+    }
+    return true;
+  }
+
+  if (sscanf(cmd, "set %1023[a-zA-Z0-9_] %f", sym, &value) == 2 ||
+      sscanf(cmd, "%1023[a-zA-Z0-9_] = %f", sym, &value) == 2) {
+    // Set host controls here, since frontends only handle plugin ports
+    const ControlID* const control = jalv_control_by_symbol(jalv, sym);
+    if (control && control->type == HOST) {
+      jalv_set_control(
+        jalv, control, sizeof(value), jalv->urids.atom_Float, &value);
+      jalv_log(JALV_LOG_INFO, "%s = %f\n", sym, value);
+      return true;
+    }
+  }
+
+  return false;
+}
@@ -0,0 +1,36 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+#ifndef JALV_COMMAND_H
+#define JALV_COMMAND_H
+
+#include "attributes.h"
+#include "types.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+JALV_BEGIN_DECLS
+
+// Commands shared by all frontends, in addition to their own
+
+/// Print help for the shared commands
+void
+jalv_print_host_commands(FILE* stream);
+
+/**
+   Process a shared command line.
+
+   @return True if the command was handled, otherwise false and the frontend
+   should try its own commands.
+*/
+bool
+jalv_process_host_command(Jalv* jalv, const char* cmd);
+
+/// Write the "mod" commands that set up all active modulators
+void
+jalv_write_modulators(Jalv* jalv, FILE* stream);
+
+JALV_END_DECLS
+
+#endif // JALV_COMMAND_H
@@ -12,6 +12,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -167,6 +168,34 @@ new_property_control(LilvWorld* const       world,
   return id;
 }
 
+ControlID*
+new_host_control(LilvWorld* const      world,
+                 const uint32_t        index,
+                 const char* const     symbol,
+                 const char* const     label,
+                 const float           min,
+                 const float           max,
+                 const float           def,
+                 LV2_Atom_Forge* const forge)
+{
+  char uri[128];
+  snprintf(uri, sizeof(uri), "%s%s", JALV_HOST_CONTROL_PREFIX, symbol);
+
+  ControlID* id   = (ControlID*)calloc(1, sizeof(ControlID));
+  id->type        = HOST;
+  id->node        = lilv_new_uri(world, uri);
+  id->symbol      = lilv_new_string(world, symbol);
+  id->label       = lilv_new_string(world, label);
+  id->forge       = forge;
+  id->index       = index;
+  id->value_type  = forge->Float;
+  id->min         = lilv_new_float(world, min);
+  id->max         = lilv_new_float(world, max);
+  id->def         = lilv_new_float(world, def);
+  id->is_writable = true;
+  return id;
+}
+
 void
 add_control(Controls* controls, ControlID* control)
 {
@@ -21,10 +21,20 @@ JALV_BEGIN_DECLS
 
 /// Type of plugin control
 typedef enum {
-  PORT,    ///< Control port
-  PROPERTY ///< Property (set via atom message)
+  PORT,     ///< Control port
+  PROPERTY, ///< Property (set via atom message)
+  HOST      ///< Host pseudo-control, like a port but applied by Jalv
 } ControlType;
 
+/// URI prefix for host pseudo-controls
+#define JALV_HOST_CONTROL_PREFIX "http://drobilla.net/ns/jalv#"
+
+/// Protocol for a batch of ControlValue sent from the UI to the plugin
+#define JALV__ControlBatch JALV_HOST_CONTROL_PREFIX "ControlBatch"
+
+/// Protocol for the events of an output sequence sent from the plugin to the UI
+#define JALV__EventSequence JALV_HOST_CONTROL_PREFIX "EventSequence"
+
 // "Interesting" value in a control's value range
 typedef struct {
   float value;
@@ -39,7 +49,7 @@ typedef struct {
   LilvNode*       label;          ///< Human readable label
   LV2_Atom_Forge* forge;          ///< Forge (for URIDs)
   LV2_URID        property;       ///< Iff type == PROPERTY
-  uint32_t        index;          ///< Iff type == PORT
+  uint32_t        index;          ///< Iff type == PORT or HOST
   LilvNode*       group;          ///< Port/control group, or NULL
   void*           widget;         ///< Control Widget
   size_t          n_points;       ///< Number of scale points
@@ -67,9 +77,16 @@ typedef struct {
   uint32_t index;
   uint32_t protocol;
   uint32_t size;
+  uint64_t time; ///< Clock time when sent to the plugin, or zero
   // Followed immediately by size bytes of data
 } ControlChange;
 
+/// Value of a control port, sent to the plugin in batches
+typedef struct {
+  uint32_t index;
+  float    value;
+} ControlValue;
+
 /// Order scale points by value
 int
 scale_point_cmp(const ScalePoint* a, const ScalePoint* b);
@@ -92,6 +109,17 @@ new_property_control(LilvWorld*       world,
                      LV2_URID_Map*    map,
                      LV2_Atom_Forge*  forge);
 
+/// Create a new ID for a host pseudo-control with a float value
+ControlID*
+new_host_control(LilvWorld*      world,
+                 uint32_t        index,
+                 const char*     symbol,
+                 const char*     label,
+                 float           min,
+                 float           max,
+                 float           def,
+                 LV2_Atom_Forge* forge);
+
 void
 add_control(Controls* controls, ControlID* control);
 
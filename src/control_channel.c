@@ -0,0 +1,171 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+#include "control_channel.h"
+
+#include "atomic.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Number of ports per word of dirty bits
+#define JALV_DIRTY_WORD_BITS 32U
+
+struct JalvControlChannelImpl {
+  uint32_t* values;  ///< Value of each port as float bits (atomic)
+  uint32_t* dirty;   ///< Bit for each port with an unread value (atomic)
+  uint32_t  n_ports; ///< Number of plugin ports
+  uint32_t  n_words; ///< Number of words of dirty bits
+};
+
+JalvControlChannel*
+jalv_control_channel_new(const uint32_t n_ports)
+{
+  JalvControlChannel* const channel =
+    (JalvControlChannel*)calloc(1, sizeof(JalvControlChannel));
+  if (!channel) {
+    return NULL;
+  }
+
+  const uint32_t n_words =
+    (n_ports + JALV_DIRTY_WORD_BITS - 1U) / JALV_DIRTY_WORD_BITS;
+
+  channel->n_ports = n_ports;
+  channel->n_words = n_words;
+  channel->values  = (uint32_t*)calloc(n_ports + 1U, sizeof(uint32_t));
+  channel->dirty   = (uint32_t*)calloc(n_words + 1U, sizeof(uint32_t));
+  if (!channel->values || !channel->dirty) {
+    jalv_control_channel_free(channel);
+    return NULL;
+  }
+
+  return channel;
+}
+
+void
+jalv_control_channel_free(JalvControlChannel* const channel)
+{
+  if (channel) {
+    free(channel->values);
+    free(channel->dirty);
+    free(channel);
+  }
+}
+
+void
+jalv_control_channel_write(JalvControlChannel* const channel,
+                           const uint32_t            port_index,
+                           const float               value)
+{
+  if (port_index >= channel->n_ports) {
+    return;
+  }
+
+  uint32_t bits = 0U;
+  memcpy(&bits, &value, sizeof(bits));
+
+  // Store the value before marking it, so the reader never sees a stale one
+  JALV_ATOMIC_STORE(&channel->values[port_index], bits);
+  JALV_ATOMIC_OR(&channel->dirty[port_index / JALV_DIRTY_WORD_BITS],
+                 1U << (port_index % JALV_DIRTY_WORD_BITS));
+}
+
+uint32_t
+jalv_control_channel_read(JalvControlChannel* const channel,
+                          const JalvControlSink     sink,
+                          void* const               handle)
+{
+  uint32_t n_read = 0U;
+  for (uint32_t w = 0U; w < channel->n_words; ++w) {
+    if (!JALV_ATOMIC_LOAD(&channel->dirty[w])) {
+      continue;
+    }
+
+    // Clear the dirty bits first, so a concurrent write is read next time
+    uint32_t dirty = (uint32_t)JALV_ATOMIC_EXCHANGE(&channel->dirty[w], 0U);
+    for (uint32_t b = 0U; dirty; ++b, dirty >>= 1U) {
+      if (dirty & 1U) {
+        const uint32_t index = w * JALV_DIRTY_WORD_BITS + b;
+        const uint32_t bits  = JALV_ATOMIC_LOAD(&channel->values[index]);
+        float          value = 0.0f;
+
+        memcpy(&value, &bits, sizeof(value));
+        sink(handle, index, value);
+        ++n_read;
+      }
+    }
+  }
+
+  return n_read;
+}
+
+#ifdef CONTROL_CHANNEL_STANDALONE
+
+#  include <stdio.h>
+
+#  define TEST_N_PORTS 70U
+
+typedef struct {
+  float    values[TEST_N_PORTS];
+  uint32_t last_index;
+  int      st;
+} TestSink;
+
+static void
+test_sink(void* const handle, const uint32_t index, const float value)
+{
+  TestSink* const test = (TestSink*)handle;
+  if (index >= TEST_N_PORTS || (test->last_index != UINT32_MAX &&
+                                index <= test->last_index)) {
+    test->st = fprintf(stderr, "error: Read port %u out of order\n", index);
+    return;
+  }
+
+  test->values[index] = value;
+  test->last_index    = index;
+}
+
+static uint32_t
+test_read(JalvControlChannel* const channel, TestSink* const test)
+{
+  test->last_index = UINT32_MAX;
+  return jalv_control_channel_read(channel, test_sink, test);
+}
+
+int
+main(void)
+{
+  JalvControlChannel* const channel = jalv_control_channel_new(TEST_N_PORTS);
+  TestSink                  test    = {{0.0f}, UINT32_MAX, 0};
+  int                       st      = 0;
+
+  // Nothing is read from a fresh channel
+  st |= test_read(channel, &test) != 0U;
+
+  // Many writes to the same port are read once, as the last value
+  for (uint32_t i = 0U; i < 100U; ++i) {
+    jalv_control_channel_write(channel, 33U, (float)i);
+  }
+
+  st |= test_read(channel, &test) != 1U || test.values[33] != 99.0f;
+  st |= test_read(channel, &test) != 0U;
+
+  // Writes to ports in several words are read in order of port index
+  jalv_control_channel_write(channel, 69U, 3.0f);
+  jalv_control_channel_write(channel, 0U, 1.0f);
+  jalv_control_channel_write(channel, 31U, 2.0f);
+  jalv_control_channel_write(channel, 70U, 4.0f);
+  st |= test_read(channel, &test) != 3U;
+  st |= test.values[0] != 1.0f || test.values[31] != 2.0f ||
+        test.values[69] != 3.0f;
+
+  jalv_control_channel_free(channel);
+  if (st || test.st) {
+    fprintf(stderr, "error: Unexpected control channel state\n");
+  }
+
+  return st || test.st;
+}
+
+#endif // CONTROL_CHANNEL_STANDALONE
@@ -0,0 +1,60 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+/**
+   @file control_channel.h A lock-free channel for control port values.
+
+   This passes control port values from one writer thread to one reader
+   thread.  Each port has a single value and a dirty bit, so the last value
+   written wins and a port changed many times between reads is only read
+   once.  Readers only look at the values of ports that have changed, a word
+   of dirty bits at a time.
+*/
+
+#ifndef JALV_CONTROL_CHANNEL_H
+#define JALV_CONTROL_CHANNEL_H
+
+#include "attributes.h"
+
+#include <stdint.h>
+
+JALV_BEGIN_DECLS
+
+typedef struct JalvControlChannelImpl JalvControlChannel;
+
+/// Function called with each changed value when reading a channel
+typedef void (*JalvControlSink)(void* handle, uint32_t index, float value);
+
+/// Create a new channel for a plugin with `n_ports` ports
+JalvControlChannel*
+jalv_control_channel_new(uint32_t n_ports);
+
+/// Free a channel
+void
+jalv_control_channel_free(JalvControlChannel* channel);
+
+/// Set the value of a port, replacing any unread value (realtime safe)
+void
+jalv_control_channel_write(JalvControlChannel* channel,
+                           uint32_t            port_index,
+                           float               value);
+
+/**
+   Read the values of all ports that have changed since the last read.
+
+   This is realtime safe if `sink` is.
+
+   @param channel The channel.
+   @param sink Function called with the latest value of each changed port, in
+   order of port index.
+   @param handle Opaque pointer passed to `sink`.
+   @return The number of values read.
+*/
+uint32_t
+jalv_control_channel_read(JalvControlChannel* channel,
+                          JalvControlSink     sink,
+                          void*               handle);
+
+JALV_END_DECLS
+
+#endif // JALV_CONTROL_CHANNEL_H
@@ -0,0 +1,308 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+#include "dsp.h"
+
+#include "jalv_config.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+  Kernels are written with GCC vector extensions where available, which
+  compile to SSE or NEON without any target-specific code.  Vectors are loaded
+  and stored with memcpy() so buffers need not be aligned.
+*/
+
+#if defined(__GNUC__)
+#  define JALV_DSP_VECTORS 1
+
+typedef float   JalvFloat4 __attribute__((vector_size(16)));
+typedef int32_t JalvInt4 __attribute__((vector_size(16)));
+
+static inline JalvFloat4
+load4(const float* const src)
+{
+  JalvFloat4 v;
+  memcpy(&v, src, sizeof(v));
+  return v;
+}
+
+static inline void
+store4(float* const dst, const JalvFloat4 v)
+{
+  memcpy(dst, &v, sizeof(v));
+}
+
+static inline JalvFloat4
+splat4(const float x)
+{
+  const JalvFloat4 v = {x, x, x, x};
+  return v;
+}
+
+/// Return the absolute value of each element by clearing the sign bits
+static inline JalvFloat4
+abs4(const JalvFloat4 v)
+{
+  const JalvInt4 mask = {0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF};
+  return (JalvFloat4)((JalvInt4)v & mask);
+}
+
+/// Return the maximum of each pair of elements
+static inline JalvFloat4
+max4(const JalvFloat4 a, const JalvFloat4 b)
+{
+  const JalvInt4 gt = a > b;
+  return (JalvFloat4)(((JalvInt4)a & gt) | ((JalvInt4)b & ~gt));
+}
+
+#else
+#  define JALV_DSP_VECTORS 0
+#endif
+
+float*
+jalv_dsp_alloc(const uint32_t n_frames)
+{
+  const size_t size = (n_frames ? n_frames : 1U) * sizeof(float);
+
+#if USE_POSIX_MEMALIGN
+  void* buf = NULL;
+  if (posix_memalign(&buf, 16, size)) {
+    return NULL;
+  }
+
+  memset(buf, 0, size);
+  return (float*)buf;
+#else
+  return (float*)calloc(1, size);
+#endif
+}
+
+void
+jalv_dsp_free(float* const buf)
+{
+  free(buf);
+}
+
+void
+jalv_dsp_copy_gain(float* const       dst,
+                   const float* const src,
+                   const uint32_t     n_frames,
+                   const float        gain)
+{
+  uint32_t i = 0U;
+
+#if JALV_DSP_VECTORS
+  const JalvFloat4 g = splat4(gain);
+  for (; i + 4U <= n_frames; i += 4U) {
+    store4(dst + i, load4(src + i) * g);
+  }
+#endif
+
+  for (; i < n_frames; ++i) {
+    dst[i] = src[i] * gain;
+  }
+}
+
+void
+jalv_dsp_add_gain(float* const       dst,
+                  const float* const src,
+                  const uint32_t     n_frames,
+                  const float        gain)
+{
+  uint32_t i = 0U;
+
+#if JALV_DSP_VECTORS
+  const JalvFloat4 g = splat4(gain);
+  for (; i + 4U <= n_frames; i += 4U) {
+    store4(dst + i, load4(dst + i) + load4(src + i) * g);
+  }
+#endif
+
+  for (; i < n_frames; ++i) {
+    dst[i] += src[i] * gain;
+  }
+}
+
+void
+jalv_dsp_crossfade(float* const       dst,
+                   const float* const wet,
+                   const float* const dry,
+                   const uint32_t     n_frames,
+                   const float        g0,
+                   const float        g1)
+{
+  const float step = n_frames ? (g1 - g0) / (float)n_frames : 0.0f;
+  uint32_t    i    = 0U;
+
+#if JALV_DSP_VECTORS
+  JalvFloat4       g     = {g0, g0 + step, g0 + 2.0f * step, g0 + 3.0f * step};
+  const JalvFloat4 step4 = splat4(4.0f * step);
+
+  if (dry) {
+    for (; i + 4U <= n_frames; i += 4U) {
+      const JalvFloat4 d = load4(dry + i);
+      store4(dst + i, d + (load4(wet + i) - d) * g);
+      g += step4;
+    }
+  } else {
+    for (; i + 4U <= n_frames; i += 4U) {
+      store4(dst + i, load4(wet + i) * g);
+      g += step4;
+    }
+  }
+#endif
+
+  for (; i < n_frames; ++i) {
+    const float gain = g0 + step * (float)i;
+    const float d    = dry ? dry[i] : 0.0f;
+    dst[i]           = d + (wet[i] - d) * gain;
+  }
+}
+
+float
+jalv_dsp_dot(const float* const a, const float* const b, const uint32_t n)
+{
+  float    sum = 0.0f;
+  uint32_t i   = 0U;
+
+#if JALV_DSP_VECTORS
+  JalvFloat4 sum4 = splat4(0.0f);
+  for (; i + 4U <= n; i += 4U) {
+    sum4 += load4(a + i) * load4(b + i);
+  }
+
+  sum = (sum4[0] + sum4[1]) + (sum4[2] + sum4[3]);
+#endif
+
+  for (; i < n; ++i) {
+    sum += a[i] * b[i];
+  }
+
+  return sum;
+}
+
+float
+jalv_dsp_peak(const float* const buf, const uint32_t n_frames)
+{
+  float    peak = 0.0f;
+  uint32_t i    = 0U;
+
+#if JALV_DSP_VECTORS
+  JalvFloat4 peak4 = splat4(0.0f);
+  for (; i + 4U <= n_frames; i += 4U) {
+    peak4 = max4(peak4, abs4(load4(buf + i)));
+  }
+
+  for (unsigned j = 0U; j < 4U; ++j) {
+    peak = peak4[j] > peak ? peak4[j] : peak;
+  }
+#endif
+
+  for (; i < n_frames; ++i) {
+    const float a = fabsf(buf[i]);
+    peak          = a > peak ? a : peak;
+  }
+
+  return peak;
+}
+
+#ifdef DSP_STANDALONE
+
+#  include <stdio.h>
+
+static int
+test_crossfade(const uint32_t n_frames, const int use_dry)
+{
+#  define MAX_FRAMES 67
+
+  float wet[MAX_FRAMES];
+  float dry[MAX_FRAMES];
+  float out[MAX_FRAMES];
+  for (uint32_t i = 0U; i < MAX_FRAMES; ++i) {
+    wet[i] = (float)i * 0.25f;
+    dry[i] = 1.0f - (float)i * 0.125f;
+  }
+
+  const float g0 = 0.25f;
+  const float g1 = 0.75f;
+  jalv_dsp_crossfade(out, wet, use_dry ? dry : NULL, n_frames, g0, g1);
+
+  for (uint32_t i = 0U; i < n_frames; ++i) {
+    const float g = g0 + (g1 - g0) * (float)i / (float)n_frames;
+    const float d = use_dry ? dry[i] : 0.0f;
+    if (fabsf(out[i] - (d + (wet[i] - d) * g)) > 1.0e-5f) {
+      return fprintf(stderr, "error: Incorrect crossfade at %u\n", i);
+    }
+  }
+
+  // Processing in place must give the same result
+  jalv_dsp_crossfade(wet, wet, use_dry ? dry : NULL, n_frames, g0, g1);
+  if (n_frames && memcmp(wet, out, n_frames * sizeof(float))) {
+    return fprintf(stderr, "error: Incorrect in-place crossfade\n");
+  }
+
+  return 0;
+
+#  undef MAX_FRAMES
+}
+
+static int
+test_gain(const uint32_t n_frames)
+{
+  float* const src = jalv_dsp_alloc(n_frames);
+  float* const dst = jalv_dsp_alloc(n_frames);
+  if (!src || !dst) {
+    return fprintf(stderr, "error: Failed to allocate buffers\n");
+  }
+
+  for (uint32_t i = 0U; i < n_frames; ++i) {
+    src[i] = (float)i;
+  }
+
+  int st = 0;
+  if (jalv_dsp_dot(src, src, n_frames) !=
+      (float)((n_frames - 1.0) * n_frames * (2.0 * n_frames - 1.0) / 6.0)) {
+    st = fprintf(stderr, "error: Incorrect dot product\n");
+  }
+
+  if (n_frames) {
+    src[n_frames / 2U] = -1000.0f;
+    if (jalv_dsp_peak(src, n_frames) != 1000.0f) {
+      st = fprintf(stderr, "error: Incorrect peak\n");
+    }
+    src[n_frames / 2U] = (float)(n_frames / 2U);
+  }
+
+  jalv_dsp_copy_gain(dst, src, n_frames, 0.5f);
+  jalv_dsp_add_gain(dst, src, n_frames, 2.0f);
+  for (uint32_t i = 0U; i < n_frames && !st; ++i) {
+    if (dst[i] != (float)i * 2.5f) {
+      st = fprintf(stderr, "error: Incorrect gain at %u\n", i);
+    }
+  }
+
+  jalv_dsp_free(dst);
+  jalv_dsp_free(src);
+  return st;
+}
+
+int
+main(void)
+{
+  static const uint32_t lengths[] = {0U, 1U, 3U, 4U, 17U, 64U, 67U};
+
+  for (unsigned i = 0U; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+    if (test_crossfade(lengths[i], 0) || test_crossfade(lengths[i], 1) ||
+        test_gain(lengths[i])) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+#endif // DSP_STANDALONE
@@ -0,0 +1,63 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+/**
+   @file dsp.h Simple vectorised audio kernels for host-side processing.
+
+   These are used by the host for small amounts of processing around the
+   plugin, like fades and mixing.  All are realtime safe, and work with
+   unaligned buffers of any length.
+*/
+
+#ifndef JALV_DSP_H
+#define JALV_DSP_H
+
+#include "attributes.h"
+
+#include <stdint.h>
+
+JALV_BEGIN_DECLS
+
+/// Allocate a zeroed audio buffer aligned for vector access
+float*
+jalv_dsp_alloc(uint32_t n_frames);
+
+/// Free a buffer allocated with jalv_dsp_alloc()
+void
+jalv_dsp_free(float* buf);
+
+/// Copy `src` to `dst` with a constant gain
+void
+jalv_dsp_copy_gain(float* dst, const float* src, uint32_t n_frames, float gain);
+
+/// Add `src` to `dst` with a constant gain
+void
+jalv_dsp_add_gain(float* dst, const float* src, uint32_t n_frames, float gain);
+
+/**
+   Crossfade from `dry` to `wet` with a linear gain ramp.
+
+   The gain of `wet` ramps from `g0` at the first frame towards `g1` at the
+   last, and `dry` has the complementary gain, so `dst[i] = dry[i] + (wet[i] -
+   dry[i]) * g`.  If `dry` is null, it is treated as silence.  The output may
+   be the same buffer as either input.
+*/
+void
+jalv_dsp_crossfade(float*       dst,
+                   const float* wet,
+                   const float* dry,
+                   uint32_t     n_frames,
+                   float        g0,
+                   float        g1);
+
+/// Return the dot product of `a` and `b`
+float
+jalv_dsp_dot(const float* a, const float* b, uint32_t n);
+
+/// Return the maximum absolute value in `buf`, or 0 if `n_frames` is 0
+float
+jalv_dsp_peak(const float* buf, uint32_t n_frames);
+
+JALV_END_DECLS
+
+#endif // JALV_DSP_H
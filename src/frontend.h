@@ -36,6 +36,10 @@ jalv_frontend_refresh_rate(Jalv* jalv);
 float
 jalv_frontend_scale_factor(Jalv* jalv);
 
+/// Subscribe the generic UI to the plugin events it needs
+void
+jalv_frontend_subscribe(Jalv* jalv);
+
 /// Attempt to get a plugin URI selection from the user
 LilvNode*
 jalv_frontend_select_plugin(Jalv* jalv);
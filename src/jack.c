@@ -1,18 +1,28 @@
 // Copyright 2007-2022 David Robillard <d@drobilla.net>
 // SPDX-License-Identifier: ISC
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#  define _GNU_SOURCE // For pthread_setaffinity_np()
+#endif
+
 #include "backend.h"
 
+#include "atomic.h"
+#include "clock.h"
+#include "dsp.h"
 #include "frontend.h"
 #include "jalv_config.h"
 #include "jalv_internal.h"
 #include "log.h"
 #include "lv2_evbuf.h"
+#include "modulator.h"
 #include "nodes.h"
 #include "options.h"
+#include "oversampler.h"
 #include "port.h"
 #include "types.h"
 #include "urids.h"
+#include "wakeup.h"
 #include "control.h"
 
 #include "lilv/lilv.h"
@@ -23,6 +33,7 @@
 
 #include <jack/jack.h>
 #include <jack/midiport.h>
+#include <jack/thread.h>
 #include <jack/transport.h>
 #include <jack/types.h>
 
@@ -31,6 +42,7 @@
 #endif
 
 #include <ctype.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -38,17 +50,157 @@
 #include <string.h>
 #include <math.h>
 
+#ifdef _WIN32
+#  include <synchapi.h>
+#else
+#  include <sched.h>
+#endif
+
+#if USE_PTHREAD_SETAFFINITY_NP
+#  include <pthread.h>
+#endif
+
 #ifdef __clang__
 #  define REALTIME __attribute__((annotate("realtime")))
 #else
 #  define REALTIME
 #endif
 
+/// Buffers exchanged between the Jack process thread and the DSP thread
+typedef struct {
+  float**     audio;  ///< Audio buffer for each audio/CV port, or NULL
+  LV2_Evbuf** events; ///< Event buffer for each event port, or NULL
+} JalvPipelineSlot;
+
+/// Timing statistics for pipelined execution (durations in nanoseconds)
+typedef struct {
+  uint64_t cycles;        ///< Number of periods handed to the DSP thread
+  uint64_t misses;        ///< Number of periods the DSP thread was late
+  uint64_t handoff_last;  ///< Duration of the last buffer exchange
+  uint64_t handoff_max;   ///< Longest buffer exchange
+  uint64_t handoff_total; ///< Total duration of all buffer exchanges
+  uint64_t run_last;      ///< Duration of the last DSP cycle
+  uint64_t run_max;       ///< Longest DSP cycle
+  uint64_t run_total;     ///< Total duration of all DSP cycles
+} JalvPipelineStats;
+
+/**
+   State for running the plugin one period behind Jack in a DSP thread.
+
+   The Jack process callback only copies buffers: it reads the outputs of the
+   previous period from the slot the DSP thread last processed, writes the
+   inputs of this period into the other slot, then hands that slot to the DSP
+   thread.  Each slot therefore has exactly one owner at any time.
+*/
+typedef struct {
+  JalvPipelineSlot     slots[2];        ///< Double-buffered exchange slots
+  unsigned             dsp_slot;        ///< Index of slot for the DSP thread
+  jack_nframes_t       nframes;         ///< Number of frames in dsp_slot
+  jack_native_thread_t thread;          ///< DSP thread
+  ZixSem               sem;             ///< Signals DSP thread to run
+  int                  busy;            ///< DSP thread is processing (atomic)
+  int                  exit;            ///< DSP thread exit flag (atomic)
+  int                  latency_changed; ///< Plugin latency changed (atomic)
+  bool                 running;         ///< DSP thread is running
+  bool                 stale;           ///< Outputs in dsp_slot are stale
+  JalvPipelineStats    stats;           ///< Timing statistics
+} JalvPipeline;
+
+/// Specialised process callback, chosen at activation
+typedef enum {
+  JALV_PROCESS_FULL,  ///< Generic callback that supports everything
+  JALV_PROCESS_AUDIO, ///< Audio and control ports only
+  JALV_PROCESS_SYNTH, ///< Event inputs, but no event outputs
+  JALV_PROCESS_OVERSAMPLED, ///< Generic callback with oversampling
+} JalvProcessVariant;
+
+static const char* const jack_process_variant_names[] = {
+  "full", "audio", "synth", "oversampled"};
+
+/// Timing statistics for the process callback (durations in nanoseconds)
+typedef struct {
+  uint64_t cycles;         ///< Number of periods processed
+  uint64_t overhead_last;  ///< Host overhead (excluding jalv_run) last cycle
+  uint64_t overhead_max;   ///< Longest host overhead
+  uint64_t overhead_total; ///< Total host overhead of all cycles
+} JalvProcessStats;
+
+/**
+   Port indices precomputed at activation for the specialised callbacks.
+
+   These let the common cases run without scanning every port each cycle.
+*/
+typedef struct {
+  JalvProcessVariant variant;           ///< Selected process callback
+  uint32_t*          audio_ports;       ///< Audio/CV ports with Jack ports
+  uint32_t           n_audio_ports;     ///< Size of audio_ports
+  uint32_t*          event_inputs;      ///< Event input ports
+  uint32_t           n_event_inputs;    ///< Size of event_inputs
+  uint32_t*          control_outputs;   ///< Control outputs sent to the UI
+  uint32_t           n_control_outputs; ///< Size of control_outputs
+  int32_t            latency_port;      ///< Latency output port, or -1
+  JalvProcessStats   stats;             ///< Timing statistics
+} JalvProcessPlan;
+
+/**
+   Crossfade between plugin output and dry input when pausing and resuming.
+
+   Pausing fades the plugin output out over a few cycles before the plugin is
+   actually paused, and resuming fades it back in, so state restores don't
+   cause clicks.  While paused, each audio output passes through the audio
+   input with the same position, or is silent if there is none.
+*/
+typedef struct {
+  int32_t* dry_sources; ///< Dry input port for each output port, or -1
+  float    gain;        ///< Current gain of plugin output (0 is fully dry)
+  float    step;        ///< Gain change per frame
+} JalvPauseFade;
+
+/// Several Jack ports mixed by the host into one plugin audio input
+typedef struct {
+  uint32_t      port_index; ///< Index of plugin input port
+  uint32_t      n_sources;  ///< Number of Jack ports
+  jack_port_t** sources;    ///< Jack ports to mix
+  float*        gains;      ///< Gain of each source
+  float*        buffer;     ///< Mixed buffer for the plugin input
+} JalvInputBus;
+
+/// A Jack audio input that modulates a plugin control port
+typedef struct {
+  uint32_t     port_index; ///< Index of plugin control port
+  jack_port_t* port;       ///< Jack port
+} JalvControlInput;
+
+/**
+   Resampling to run the plugin at a multiple of the Jack sample rate.
+
+   When enabled, the sample rate and block length in Jalv are those of the
+   plugin, and each audio/CV port is connected to a buffer at the plugin rate.
+*/
+typedef struct {
+  uint32_t          factor;     ///< Oversampling factor, or 1 if disabled
+  JalvOversampler** resamplers; ///< Resampler for each audio/CV port, or null
+  float**           buffers;    ///< Plugin rate buffer for each port, or null
+} JalvOversampling;
+
 struct JalvBackendImpl {
-  jack_client_t* client;             ///< Jack client
-  bool           is_internal_client; ///< Running inside jackd
+  jack_client_t*    client;             ///< Jack client
+  bool              is_internal_client; ///< Running inside jackd
+  JalvPipeline*     pipeline;           ///< Pipelined DSP thread, or NULL
+  JalvProcessPlan   plan;               ///< Process callback configuration
+  JalvPauseFade     fade;               ///< Pause crossfade
+  float*            silence;            ///< Shared input for hidden ports
+  float*            scratch;            ///< Shared output for hidden ports
+  JalvInputBus*     buses;              ///< Mixed audio inputs
+  uint32_t          n_buses;            ///< Number of mixed audio inputs
+  JalvControlInput* control_inputs;     ///< Audio inputs for controls
+  uint32_t          n_control_inputs;   ///< Number of audio inputs for controls
+  JalvOversampling  oversampling;       ///< Plugin oversampling
 };
 
+/// Duration of the crossfade when pausing or resuming in seconds
+#define JALV_PAUSE_FADE_TIME 0.01f
+
 /// Internal Jack client initialization entry point
 int
 jack_initialize(jack_client_t* client, const char* load_init);
@@ -57,18 +209,321 @@ jack_initialize(jack_client_t* client, const char* load_init);
 void
 jack_finish(void* arg);
 
+/// Return the input bus for a plugin port, or null
+static JalvInputBus*
+jack_find_bus(const JalvBackend* const backend, const uint32_t port_index)
+{
+  for (uint32_t i = 0U; i < backend->n_buses; ++i) {
+    if (backend->buses[i].port_index == port_index) {
+      return &backend->buses[i];
+    }
+  }
+
+  return NULL;
+}
+
+/// Return true iff a port has an audio buffer from Jack or an input bus
+static bool
+jack_port_has_audio(const Jalv* const jalv, const uint32_t port_index)
+{
+  const struct Port* const port = &jalv->ports[port_index];
+  return (port->type == TYPE_AUDIO || port->type == TYPE_CV) &&
+         (port->sys_port || jack_find_bus(jalv->backend, port_index));
+}
+
+/// Return the audio input buffer of a port for this cycle
+static REALTIME const float*
+jack_audio_input(const Jalv* const    jalv,
+                 const uint32_t       port_index,
+                 const jack_nframes_t nframes)
+{
+  jack_port_t* const sys_port = jalv->ports[port_index].sys_port;
+  if (sys_port) {
+    return (const float*)jack_port_get_buffer(sys_port, nframes);
+  }
+
+  const JalvInputBus* const bus = jack_find_bus(jalv->backend, port_index);
+  return bus ? bus->buffer : NULL;
+}
+
+/// Mix the sources of every input bus for this cycle
+static REALTIME void
+jack_mix_input_buses(Jalv* const jalv, const jack_nframes_t nframes)
+{
+  for (uint32_t b = 0U; b < jalv->backend->n_buses; ++b) {
+    JalvInputBus* const bus = &jalv->backend->buses[b];
+    for (uint32_t i = 0U; i < bus->n_sources; ++i) {
+      const float* const src =
+        (const float*)jack_port_get_buffer(bus->sources[i], nframes);
+      if (i == 0U) {
+        jalv_dsp_copy_gain(bus->buffer, src, nframes, bus->gains[i]);
+      } else {
+        jalv_dsp_add_gain(bus->buffer, src, nframes, bus->gains[i]);
+      }
+    }
+  }
+}
+
+/// Reduce a cycle of every control input for the modulators
+static REALTIME void
+jack_read_control_inputs(Jalv* const jalv, const jack_nframes_t nframes)
+{
+  for (uint32_t i = 0U; i < jalv->backend->n_control_inputs; ++i) {
+    const JalvControlInput* const input = &jalv->backend->control_inputs[i];
+    jalv_modulators_read_input(
+      jalv->modulators,
+      input->port_index,
+      (const float*)jack_port_get_buffer(input->port, nframes),
+      nframes);
+  }
+}
+
+/// Allocate the mix buffers of input buses and connect them to the plugin
+static int
+jack_connect_input_buses(Jalv* const jalv)
+{
+  for (uint32_t b = 0U; b < jalv->backend->n_buses; ++b) {
+    JalvInputBus* const bus = &jalv->backend->buses[b];
+
+    jalv_dsp_free(bus->buffer);
+    if (!(bus->buffer = jalv_dsp_alloc(jalv->block_length))) {
+      return 1;
+    }
+
+    jalv_connect_audio_port(jalv, bus->port_index, bus->buffer);
+  }
+
+  return 0;
+}
+
+/// Free the buffers of a pipeline
+static void
+jack_pipeline_free_buffers(Jalv* const jalv, JalvPipeline* const pipe)
+{
+  for (unsigned s = 0U; s < 2U; ++s) {
+    JalvPipelineSlot* const slot = &pipe->slots[s];
+    for (uint32_t p = 0; p < jalv->num_ports; ++p) {
+      if (slot->audio) {
+        free(slot->audio[p]);
+      }
+      if (slot->events) {
+        lv2_evbuf_free(slot->events[p]);
+      }
+    }
+
+    free(slot->audio);
+    free(slot->events);
+    slot->audio  = NULL;
+    slot->events = NULL;
+  }
+}
+
+/// Allocate the buffers of one pipeline slot for the block length
+static int
+jack_pipeline_allocate_slot(Jalv* const             jalv,
+                            JalvPipelineSlot* const slot,
+                            const LV2_URID          atom_Chunk,
+                            const LV2_URID          atom_Sequence)
+{
+  slot->audio  = (float**)calloc(jalv->num_ports, sizeof(float*));
+  slot->events = (LV2_Evbuf**)calloc(jalv->num_ports, sizeof(LV2_Evbuf*));
+  if (!slot->audio || !slot->events) {
+    return 1;
+  }
+
+  for (uint32_t p = 0; p < jalv->num_ports; ++p) {
+    const struct Port* const port = &jalv->ports[p];
+    if (jack_port_has_audio(jalv, p)) {
+      slot->audio[p] = (float*)calloc(jalv->block_length, sizeof(float));
+      if (!slot->audio[p]) {
+        return 1;
+      }
+    } else if (port->type == TYPE_EVENT) {
+      const size_t size = port->buf_size ? port->buf_size : jalv->midi_buf_size;
+
+      slot->events[p] = lv2_evbuf_new(size, atom_Chunk, atom_Sequence);
+      if (!slot->events[p]) {
+        return 1;
+      }
+
+      lv2_evbuf_reset(slot->events[p], port->flow == FLOW_INPUT);
+    }
+  }
+
+  return 0;
+}
+
+/// Allocate (or reallocate) the buffers of a pipeline for the block length
+static int
+jack_pipeline_allocate(Jalv* const jalv, JalvPipeline* const pipe)
+{
+  const LV2_URID atom_Chunk = jalv->map.map(
+    jalv->map.handle, lilv_node_as_string(jalv->nodes.atom_Chunk));
+
+  const LV2_URID atom_Sequence = jalv->map.map(
+    jalv->map.handle, lilv_node_as_string(jalv->nodes.atom_Sequence));
+
+  jack_pipeline_free_buffers(jalv, pipe);
+
+  for (unsigned s = 0U; s < 2U; ++s) {
+    if (jack_pipeline_allocate_slot(
+          jalv, &pipe->slots[s], atom_Chunk, atom_Sequence)) {
+      jack_pipeline_free_buffers(jalv, pipe);
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+   Wait until the DSP thread has finished the period it is processing.
+
+   This spins, yielding the processor each time around, but is only used from
+   non-realtime callbacks, and waits for at most one period.
+*/
+static void
+jack_pipeline_wait_idle(JalvPipeline* const pipe)
+{
+  while (pipe->running && JALV_ATOMIC_LOAD(&pipe->busy)) {
+#ifdef _WIN32
+    Sleep(0);
+#else
+    sched_yield();
+#endif
+  }
+}
+
+/// Free the resamplers and buffers for oversampling
+static void
+jack_oversampling_free(Jalv* const jalv, JalvOversampling* const os)
+{
+  for (uint32_t p = 0; p < jalv->num_ports; ++p) {
+    if (os->resamplers) {
+      jalv_oversampler_free(os->resamplers[p]);
+    }
+    if (os->buffers) {
+      jalv_dsp_free(os->buffers[p]);
+    }
+  }
+
+  free(os->resamplers);
+  free(os->buffers);
+  os->resamplers = NULL;
+  os->buffers    = NULL;
+}
+
+/// Allocate resamplers and connect the plugin to buffers at its rate
+static int
+jack_oversampling_init(Jalv* const jalv, JalvOversampling* const os)
+{
+  jack_oversampling_free(jalv, os);
+  if (os->factor <= 1U) {
+    return 0;
+  }
+
+  os->resamplers =
+    (JalvOversampler**)calloc(jalv->num_ports, sizeof(JalvOversampler*));
+  os->buffers = (float**)calloc(jalv->num_ports, sizeof(float*));
+  if (!os->resamplers || !os->buffers) {
+    return 1;
+  }
+
+  const uint32_t max_frames = jalv->block_length / os->factor;
+  for (uint32_t p = 0; p < jalv->num_ports; ++p) {
+    const struct Port* const port = &jalv->ports[p];
+    if (!jack_port_has_audio(jalv, p)) {
+      continue;
+    }
+
+    if (!(os->resamplers[p] = jalv_oversampler_new(os->factor, max_frames)) ||
+        !(os->buffers[p] = jalv_dsp_alloc(jalv->block_length))) {
+      return 1;
+    }
+
+    jalv_connect_audio_port(jalv, port->index, os->buffers[p]);
+  }
+
+  return 0;
+}
+
+/// Connect audio and CV ports without a Jack port or bus to shared buffers
+static int
+jack_connect_hidden_ports(Jalv* const jalv)
+{
+  JalvBackend* const backend = jalv->backend;
+  const size_t       size    = jalv->block_length * sizeof(float);
+
+  for (uint32_t p = 0; p < jalv->num_ports; ++p) {
+    const struct Port* const port = &jalv->ports[p];
+    if ((port->type != TYPE_AUDIO && port->type != TYPE_CV) ||
+        jack_port_has_audio(jalv, p)) {
+      continue; // Not audio, or connected to a Jack port or an input bus
+    }
+
+    if (!backend->silence) {
+      // Allocate buffers the first time a hidden port is found
+      if (!(backend->silence = (float*)calloc(1, size)) ||
+          !(backend->scratch = (float*)calloc(1, size))) {
+        return 1;
+      }
+    }
+
+    jalv_connect_audio_port(
+      jalv, p, port->flow == FLOW_INPUT ? backend->silence : backend->scratch);
+  }
+
+  return 0;
+}
+
 /// Jack buffer size callback
 static int
 jack_buffer_size_cb(jack_nframes_t nframes, void* data)
 {
-  Jalv* const jalv   = (Jalv*)data;
-  jalv->block_length = nframes;
+  Jalv* const         jalv = (Jalv*)data;
+  JalvPipeline* const pipe = jalv->backend ? jalv->backend->pipeline : NULL;
+  if (pipe) {
+    // Wait for the DSP thread to finish the previous period
+    jack_pipeline_wait_idle(pipe);
+  }
+
+  const uint32_t factor =
+    jalv->backend ? jalv->backend->oversampling.factor : 1U;
+
+  jalv->block_length = nframes * factor;
   jalv->buf_size_set = true;
 #if USE_JACK_PORT_TYPE_GET_BUFFER_SIZE
   jalv->midi_buf_size = jack_port_type_get_buffer_size(jalv->backend->client,
                                                        JACK_DEFAULT_MIDI_TYPE);
 #endif
   jalv_allocate_port_buffers(jalv);
+
+  if (jalv->backend && jalv->backend->silence) {
+    // Reallocate shared buffers for hidden ports
+    free(jalv->backend->silence);
+    free(jalv->backend->scratch);
+    jack_oversampling_free(jalv, &jalv->backend->oversampling);
+    jalv->backend->silence = NULL;
+    jalv->backend->scratch = NULL;
+    if (jack_connect_hidden_ports(jalv)) {
+      jalv_log(JALV_LOG_ERR, "Failed to allocate hidden port buffers\n");
+    }
+  }
+
+  if (jalv->backend && jack_connect_input_buses(jalv)) {
+    jalv_log(JALV_LOG_ERR, "Failed to allocate input bus buffers\n");
+  }
+
+  if (jalv->backend &&
+      jack_oversampling_init(jalv, &jalv->backend->oversampling)) {
+    jalv_log(JALV_LOG_ERR, "Failed to allocate oversampling buffers\n");
+    jack_oversampling_free(jalv, &jalv->backend->oversampling);
+    jalv->backend->oversampling.factor = 1U;
+  }
+
+  if (pipe && jack_pipeline_allocate(jalv, pipe)) {
+    jalv_log(JALV_LOG_ERR, "Failed to allocate pipeline buffers\n");
+  }
   return 0;
 }
 
@@ -79,14 +534,26 @@ jack_shutdown_cb(void* data)
   Jalv* const jalv = (Jalv*)data;
   jalv_frontend_close(jalv);
   zix_sem_post(&jalv->done);
+  if (jalv->wakeup) {
+    jalv_wakeup_signal(jalv->wakeup);
+  }
 }
 
-/// Jack process callback
-static REALTIME int
-jack_process_cb(jack_nframes_t nframes, void* data)
+/**
+   Update the transport state from Jack for this cycle.
+
+   @param buf Buffer to write a time:Position object to.
+   @param size Size of `buf` in bytes.
+   @return The position object written to `buf` if the transport has changed
+   since the last cycle, otherwise null.
+*/
+static REALTIME const LV2_Atom*
+jack_update_transport(Jalv* const          jalv,
+                      const jack_nframes_t nframes,
+                      uint8_t* const       buf,
+                      const size_t         size)
 {
-  Jalv* const    jalv   = (Jalv*)data;
-  jack_client_t* client = jalv->backend->client;
+  jack_client_t* const client = jalv->backend->client;
 
   // Get Jack transport position
   jack_position_t pos;
@@ -97,18 +564,18 @@ jack_process_cb(jack_nframes_t nframes, void* data)
   const bool has_bbt = (pos.valid & JackPositionBBT);
   const bool xport_changed =
     (rolling != jalv->rolling || pos.frame != jalv->position ||
-    (has_bbt && (float)pos.beats_per_minute != jalv->bpm));
+     (has_bbt && (float)pos.beats_per_minute != jalv->bpm));
 
-  uint8_t   pos_buf[256];
-  LV2_Atom* lv2_pos = (LV2_Atom*)pos_buf;
+  LV2_Atom* lv2_pos = NULL;
   if (xport_changed) {
     // Build an LV2 position object to report change to plugin
-    lv2_atom_forge_set_buffer(&jalv->forge, pos_buf, sizeof(pos_buf));
+    lv2_atom_forge_set_buffer(&jalv->forge, buf, size);
     LV2_Atom_Forge*      forge = &jalv->forge;
     LV2_Atom_Forge_Frame frame;
     lv2_atom_forge_object(forge, &frame, 0, jalv->urids.time_Position);
     lv2_atom_forge_key(forge, jalv->urids.time_frame);
-    lv2_atom_forge_long(forge, pos.frame);
+    lv2_atom_forge_long(
+      forge, (int64_t)pos.frame * jalv->backend->oversampling.factor);
     lv2_atom_forge_key(forge, jalv->urids.time_speed);
     lv2_atom_forge_float(forge, rolling ? 1.0 : 0.0);
     if (has_bbt) {
@@ -125,34 +592,387 @@ jack_process_cb(jack_nframes_t nframes, void* data)
       lv2_atom_forge_float(forge, pos.beats_per_minute);
     }
 
+    lv2_pos = (LV2_Atom*)buf;
     jalv_dump_atom(jalv, stdout, "Position", lv2_pos, 32);
   }
 
-  // Update transport state to expected values for next cycle
-  jalv->position = rolling ? pos.frame + nframes : pos.frame;
-  jalv->bpm      = has_bbt ? pos.beats_per_minute : jalv->bpm;
-  jalv->rolling  = rolling;
+  // Update transport state to expected values for next cycle
+  jalv->position = rolling ? pos.frame + nframes : pos.frame;
+  jalv->bpm      = has_bbt ? pos.beats_per_minute : jalv->bpm;
+  jalv->rolling  = rolling;
+
+  // Send BPM value to designated control port, if any
+  if (xport_changed && has_bbt && jalv->bpm_port_index >= 0) {
+    struct Port* const port = &jalv->ports[jalv->bpm_port_index];
+    if (port->flow == FLOW_INPUT && port->type == TYPE_CONTROL) {
+      port->control = jalv->bpm;
+    }
+  }
+
+  return lv2_pos;
+}
+
+/// Write input events for a cycle (transport, update request, and MIDI)
+static REALTIME void
+jack_write_input_events(Jalv* const          jalv,
+                        struct Port* const   port,
+                        LV2_Evbuf* const     evbuf,
+                        const jack_nframes_t nframes,
+                        const LV2_Atom*      lv2_pos)
+{
+  lv2_evbuf_reset(evbuf, true);
+
+  // Write transport change event if applicable
+  LV2_Evbuf_Iterator iter = lv2_evbuf_begin(evbuf);
+  if (lv2_pos) {
+    lv2_evbuf_write(
+      &iter, 0, 0, lv2_pos->type, lv2_pos->size, LV2_ATOM_BODY_CONST(lv2_pos));
+  }
+
+  if (jalv->request_update) {
+    // Plugin state has changed, request an update
+    const LV2_Atom_Object get = {
+      {sizeof(LV2_Atom_Object_Body), jalv->urids.atom_Object},
+      {0, jalv->urids.patch_Get}};
+    lv2_evbuf_write(
+      &iter, 0, 0, get.atom.type, get.atom.size, LV2_ATOM_BODY_CONST(&get));
+  }
+
+  if (port->sys_port) {
+    // Write Jack MIDI input (with times at the plugin rate)
+    const uint32_t factor = jalv->backend->oversampling.factor;
+    void*          buf    = jack_port_get_buffer(port->sys_port, nframes);
+    for (uint32_t i = 0; i < jack_midi_get_event_count(buf); ++i) {
+      jack_midi_event_t ev;
+      jack_midi_event_get(&ev, buf, i);
+      lv2_evbuf_write(&iter,
+                      ev.time * factor,
+                      0,
+                      jalv->urids.midi_MidiEvent,
+                      ev.size,
+                      ev.buffer);
+    }
+  }
+}
+
+/**
+   Deliver output events from an event port.
+
+   MIDI events are written to `midi_buf` if it is not null, and all events are
+   forwarded to the UI in one message if `forward` is true.
+*/
+static REALTIME void
+jack_write_output_events(Jalv* const      jalv,
+                         const uint32_t   port_index,
+                         LV2_Evbuf* const evbuf,
+                         void* const      midi_buf,
+                         const bool       forward)
+{
+  if (midi_buf) {
+    jack_midi_clear_buffer(midi_buf);
+
+    for (LV2_Evbuf_Iterator i = lv2_evbuf_begin(evbuf); lv2_evbuf_is_valid(i);
+         i = lv2_evbuf_next(i)) {
+      // Get event from LV2 buffer
+      uint32_t frames    = 0;
+      uint32_t subframes = 0;
+      LV2_URID type      = 0;
+      uint32_t size      = 0;
+      void*    body      = NULL;
+      lv2_evbuf_get(i, &frames, &subframes, &type, &size, &body);
+
+      if (type == jalv->urids.midi_MidiEvent) {
+        // Write MIDI event to Jack output (with time at the Jack rate)
+        jack_midi_event_write(
+          midi_buf, frames / jalv->backend->oversampling.factor, body, size);
+      }
+    }
+  }
+
+  if (forward) {
+    // Forward all events to UI in a single message
+    jalv_write_events(jalv, port_index, evbuf);
+  }
+}
+
+/**
+   Write outputs for a cycle where the plugin is not run.
+
+   If `dry_sources` is not null, audio outputs with a dry source pass through
+   the corresponding input, and all other outputs are silent.
+*/
+static REALTIME void
+jack_silence_outputs(Jalv* const          jalv,
+                     const jack_nframes_t nframes,
+                     const int32_t* const dry_sources)
+{
+  for (uint32_t p = 0; p < jalv->num_ports; ++p) {
+    jack_port_t* jport = (jack_port_t*)jalv->ports[p].sys_port;
+    if (jport && jalv->ports[p].flow == FLOW_OUTPUT) {
+      void* buf = jack_port_get_buffer(jport, nframes);
+      if (jalv->ports[p].type == TYPE_EVENT) {
+        jack_midi_clear_buffer(buf);
+      } else if (dry_sources && dry_sources[p] >= 0) {
+        memcpy(buf,
+               jack_audio_input(jalv, (uint32_t)dry_sources[p], nframes),
+               nframes * sizeof(float));
+      } else {
+        memset(buf, '\0', nframes * sizeof(float));
+      }
+    }
+  }
+}
+
+/**
+   Apply the pause crossfade to the audio outputs after running the plugin.
+
+   @return True if the fade out has finished and the plugin is now paused.
+*/
+static REALTIME bool
+jack_update_fade(Jalv* const jalv, const jack_nframes_t nframes)
+{
+  JalvPauseFade* const fade    = &jalv->backend->fade;
+  const bool           pausing = jalv->play_state == JALV_PAUSE_REQUESTED;
+  if (!pausing && fade->gain >= 1.0f) {
+    return false; // Running normally
+  }
+
+  const float delta = fade->step * (float)nframes;
+  const float g0    = fade->gain;
+  const float g1 = pausing ? (g0 > delta ? g0 - delta : 0.0f)
+                           : (g0 + delta < 1.0f ? g0 + delta : 1.0f);
+
+  for (uint32_t p = 0; p < jalv->num_ports; ++p) {
+    const struct Port* const port = &jalv->ports[p];
+    if (port->type == TYPE_AUDIO && port->flow == FLOW_OUTPUT &&
+        port->sys_port) {
+      const int32_t d   = fade->dry_sources ? fade->dry_sources[p] : -1;
+      float* const  buf = (float*)jack_port_get_buffer(port->sys_port, nframes);
+      const float* const dry =
+        d >= 0 ? jack_audio_input(jalv, (uint32_t)d, nframes) : NULL;
+
+      jalv_dsp_crossfade(buf, buf, dry, nframes, g0, g1);
+    }
+  }
+
+  fade->gain = g1;
+  if (pausing && g1 <= 0.0f) {
+    jalv->play_state = JALV_PAUSED;
+    zix_sem_post(&jalv->paused);
+    return true;
+  }
+
+  return false;
+}
+
+/// Return true iff `port` is a control output that reports plugin latency
+static bool
+jack_port_reports_latency(const Jalv* const jalv, const struct Port* const port)
+{
+  return port->flow == FLOW_OUTPUT && port->type == TYPE_CONTROL &&
+         lilv_port_has_property(
+           jalv->plugin, port->lilv_port, jalv->nodes.lv2_reportsLatency);
+}
+
+/// Record the host overhead of a cycle that started at `t0`
+static REALTIME void
+jack_record_overhead(JalvProcessStats* const stats,
+                     const uint64_t          t0,
+                     const uint64_t          run_time)
+{
+  const uint64_t overhead = jalv_clock_now() - t0 - run_time;
+
+  ++stats->cycles;
+  stats->overhead_last = overhead;
+  stats->overhead_max =
+    overhead > stats->overhead_max ? overhead : stats->overhead_max;
+  stats->overhead_total += overhead;
+}
+
+/// Pass through dry input and return true if the plugin is paused
+static REALTIME bool
+jack_check_paused(Jalv* const jalv, const jack_nframes_t nframes)
+{
+  if (jalv->play_state == JALV_PAUSED) {
+    jack_silence_outputs(jalv, nframes, jalv->backend->fade.dry_sources);
+    return true;
+  }
+
+  return false;
+}
+
+/// Check the plugin latency and send control outputs to the UI
+static REALTIME void
+jack_write_control_outputs(Jalv* const                  jalv,
+                           const JalvProcessPlan* const plan,
+                           const bool                   send_ui_updates)
+{
+  if (plan->latency_port >= 0) {
+    const float latency = jalv->ports[plan->latency_port].control;
+    if (jalv->plugin_latency != latency) {
+      jalv->plugin_latency = latency;
+      jack_recompute_total_latencies(jalv->backend->client);
+    }
+  }
+
+  if (send_ui_updates) {
+    for (uint32_t i = 0U; i < plan->n_control_outputs; ++i) {
+      const uint32_t p = plan->control_outputs[i];
+      jalv_send_control_output(jalv, p);
+    }
+  }
+}
+
+/// Connect the plugin directly to the Jack buffers of its audio/CV ports
+static REALTIME void
+jack_connect_audio_ports(Jalv* const                  jalv,
+                         const JalvProcessPlan* const plan,
+                         const jack_nframes_t         nframes)
+{
+  for (uint32_t i = 0U; i < plan->n_audio_ports; ++i) {
+    const uint32_t p = plan->audio_ports[i];
+    jalv_connect_audio_port(
+      jalv, p, jack_port_get_buffer(jalv->ports[p].sys_port, nframes));
+  }
+}
+
+/// Jack process callback for plugins with only audio and control ports
+static REALTIME int
+jack_process_audio_cb(jack_nframes_t nframes, void* data)
+{
+  Jalv* const            jalv = (Jalv*)data;
+  JalvProcessPlan* const plan = &jalv->backend->plan;
+  const uint64_t         t0   = jalv_clock_now();
+
+  jack_mix_input_buses(jalv, nframes);
+  jack_read_control_inputs(jalv, nframes);
+  if (jack_check_paused(jalv, nframes)) {
+    return 0;
+  }
+
+  jack_connect_audio_ports(jalv, plan, nframes);
+
+  const uint64_t t1              = jalv_clock_now();
+  const bool     send_ui_updates = jalv_run(jalv, nframes);
+  const uint64_t run_time        = jalv_clock_now() - t1;
+
+  jack_write_control_outputs(jalv, plan, send_ui_updates);
+  jack_update_fade(jalv, nframes);
+  jack_record_overhead(&plan->stats, t0, run_time);
+  return 0;
+}
+
+/// Jack process callback for plugins with event inputs but no event outputs
+static REALTIME int
+jack_process_synth_cb(jack_nframes_t nframes, void* data)
+{
+  Jalv* const            jalv = (Jalv*)data;
+  JalvProcessPlan* const plan = &jalv->backend->plan;
+  const uint64_t         t0   = jalv_clock_now();
+
+  uint8_t               pos_buf[256];
+  const LV2_Atom* const lv2_pos =
+    jack_update_transport(jalv, nframes, pos_buf, sizeof(pos_buf));
+
+  jack_mix_input_buses(jalv, nframes);
+  jack_read_control_inputs(jalv, nframes);
+  if (jack_check_paused(jalv, nframes)) {
+    return 0;
+  }
+
+  jack_connect_audio_ports(jalv, plan, nframes);
+  for (uint32_t i = 0U; i < plan->n_event_inputs; ++i) {
+    struct Port* const port = &jalv->ports[plan->event_inputs[i]];
+    jack_write_input_events(jalv, port, port->evbuf, nframes, lv2_pos);
+  }
+  jalv->request_update = false;
+
+  const uint64_t t1              = jalv_clock_now();
+  const bool     send_ui_updates = jalv_run(jalv, nframes);
+  const uint64_t run_time        = jalv_clock_now() - t1;
+
+  jack_write_control_outputs(jalv, plan, send_ui_updates);
+  jack_update_fade(jalv, nframes);
+  jack_record_overhead(&plan->stats, t0, run_time);
+  return 0;
+}
+
+/// Jack process callback that runs the plugin at a higher sample rate
+static REALTIME int
+jack_process_oversampled_cb(jack_nframes_t nframes, void* data)
+{
+  Jalv* const                   jalv   = (Jalv*)data;
+  JalvProcessPlan* const        plan   = &jalv->backend->plan;
+  const JalvOversampling* const os     = &jalv->backend->oversampling;
+  const uint64_t                t0     = jalv_clock_now();
+  const uint32_t                factor = os->factor;
+
+  uint8_t               pos_buf[256];
+  const LV2_Atom* const lv2_pos =
+    jack_update_transport(jalv, nframes, pos_buf, sizeof(pos_buf));
+
+  jack_mix_input_buses(jalv, nframes);
+  jack_read_control_inputs(jalv, nframes);
+  if (jack_check_paused(jalv, nframes)) {
+    return 0;
+  }
+
+  // Upsample audio inputs and prepare event buffers
+  for (uint32_t p = 0; p < jalv->num_ports; ++p) {
+    struct Port* const port = &jalv->ports[p];
+    if (os->resamplers[p] && port->flow == FLOW_INPUT) {
+      jalv_oversampler_up(os->resamplers[p],
+                          jack_audio_input(jalv, p, nframes),
+                          os->buffers[p],
+                          nframes);
+    } else if (port->type == TYPE_EVENT && port->flow == FLOW_INPUT) {
+      jack_write_input_events(jalv, port, port->evbuf, nframes, lv2_pos);
+    } else if (port->type == TYPE_EVENT) {
+      lv2_evbuf_reset(port->evbuf, false);
+    }
+  }
+  jalv->request_update = false;
+
+  // Run plugin for this cycle at the higher rate
+  const uint64_t t1              = jalv_clock_now();
+  const bool     send_ui_updates = jalv_run(jalv, nframes * factor);
+  const uint64_t run_time        = jalv_clock_now() - t1;
+
+  // Downsample audio outputs and deliver events
+  for (uint32_t p = 0; p < jalv->num_ports; ++p) {
+    struct Port* const port = &jalv->ports[p];
+    if (os->resamplers[p] && port->flow == FLOW_OUTPUT) {
+      float* const out = (float*)jack_port_get_buffer(port->sys_port, nframes);
+      jalv_oversampler_down(os->resamplers[p], os->buffers[p], out, nframes);
+    } else if (port->type == TYPE_EVENT && port->flow == FLOW_OUTPUT) {
+      void* const buf =
+        port->sys_port ? jack_port_get_buffer(port->sys_port, nframes) : NULL;
+      jack_write_output_events(jalv, p, port->evbuf, buf, true);
+    }
+  }
+
+  jack_write_control_outputs(jalv, plan, send_ui_updates);
+  jack_update_fade(jalv, nframes);
+  jack_record_overhead(&plan->stats, t0, run_time);
+  return 0;
+}
+
+/// Jack process callback
+static REALTIME int
+jack_process_cb(jack_nframes_t nframes, void* data)
+{
+  Jalv* const    jalv   = (Jalv*)data;
+  jack_client_t* client = jalv->backend->client;
+  const uint64_t t0     = jalv_clock_now();
+
+  uint8_t               pos_buf[256];
+  const LV2_Atom* const lv2_pos =
+    jack_update_transport(jalv, nframes, pos_buf, sizeof(pos_buf));
 
-  switch (jalv->play_state) {
-  case JALV_PAUSE_REQUESTED:
-    jalv->play_state = JALV_PAUSED;
-    zix_sem_post(&jalv->paused);
-    break;
-  case JALV_PAUSED:
-    for (uint32_t p = 0; p < jalv->num_ports; ++p) {
-      jack_port_t* jport = jalv->ports[p].sys_port;
-      if (jport && jalv->ports[p].flow == FLOW_OUTPUT) {
-        void* buf = jack_port_get_buffer(jport, nframes);
-        if (jalv->ports[p].type == TYPE_EVENT) {
-          jack_midi_clear_buffer(buf);
-        } else {
-          memset(buf, '\0', nframes * sizeof(float));
-        }
-      }
-    }
+  jack_mix_input_buses(jalv, nframes);
+  jack_read_control_inputs(jalv, nframes);
+  if (jack_check_paused(jalv, nframes)) {
     return 0;
-  default:
-    break;
   }
 
   // Prepare port buffers
@@ -160,102 +980,196 @@ jack_process_cb(jack_nframes_t nframes, void* data)
     struct Port* port = &jalv->ports[p];
     if (port->type == TYPE_AUDIO && port->sys_port) {
       // Connect plugin port directly to Jack port buffer
-      lilv_instance_connect_port(
-        jalv->instance, p, jack_port_get_buffer(port->sys_port, nframes));
+      jalv_connect_audio_port(
+        jalv, p, jack_port_get_buffer(port->sys_port, nframes));
 #if USE_JACK_METADATA
     } else if (port->type == TYPE_CV && port->sys_port) {
       // Connect plugin port directly to Jack port buffer
-      lilv_instance_connect_port(
-        jalv->instance, p, jack_port_get_buffer(port->sys_port, nframes));
+      jalv_connect_audio_port(
+        jalv, p, jack_port_get_buffer(port->sys_port, nframes));
 #endif
     } else if (port->type == TYPE_EVENT && port->flow == FLOW_INPUT) {
-      lv2_evbuf_reset(port->evbuf, true);
-
-      // Write transport change event if applicable
-      LV2_Evbuf_Iterator iter = lv2_evbuf_begin(port->evbuf);
-      if (xport_changed) {
-        lv2_evbuf_write(
-          &iter, 0, 0, lv2_pos->type, lv2_pos->size, LV2_ATOM_BODY(lv2_pos));
-      }
-
-      if (jalv->request_update) {
-        // Plugin state has changed, request an update
-        const LV2_Atom_Object get = {
-          {sizeof(LV2_Atom_Object_Body), jalv->urids.atom_Object},
-          {0, jalv->urids.patch_Get}};
-        lv2_evbuf_write(
-          &iter, 0, 0, get.atom.type, get.atom.size, LV2_ATOM_BODY_CONST(&get));
-      }
-
-      if (port->sys_port) {
-        // Write Jack MIDI input
-        void* buf = jack_port_get_buffer(port->sys_port, nframes);
-        for (uint32_t i = 0; i < jack_midi_get_event_count(buf); ++i) {
-          jack_midi_event_t ev;
-          jack_midi_event_get(&ev, buf, i);
-          lv2_evbuf_write(
-            &iter, ev.time, 0, jalv->urids.midi_MidiEvent, ev.size, ev.buffer);
-        }
-      }
+      jack_write_input_events(jalv, port, port->evbuf, nframes, lv2_pos);
     } else if (port->type == TYPE_EVENT) {
       // Clear event output for plugin to write to
       lv2_evbuf_reset(port->evbuf, false);
-    } else if (jalv->bpm_port_index == port->index && port->flow == FLOW_INPUT && port->type == TYPE_CONTROL) {
-      // Send BPM value to designated control port, if any
-      if (xport_changed && has_bbt) {
-        port->control = jalv->bpm;
-        //jalv_print_control(jalv, port, jalv->bpm);
-      }
     }
   }
   jalv->request_update = false;
 
   // Run plugin for this cycle
-  const bool send_ui_updates = jalv_run(jalv, nframes);
+  const uint64_t t1              = jalv_clock_now();
+  const bool     send_ui_updates = jalv_run(jalv, nframes);
+  const uint64_t run_time        = jalv_clock_now() - t1;
 
   // Deliver MIDI output and UI events
   for (uint32_t p = 0; p < jalv->num_ports; ++p) {
     struct Port* const port = &jalv->ports[p];
-    if (port->flow == FLOW_OUTPUT && port->type == TYPE_CONTROL &&
-        lilv_port_has_property(
-          jalv->plugin, port->lilv_port, jalv->nodes.lv2_reportsLatency)) {
-      if (jalv->plugin_latency != port->control) {
+    if (jack_port_reports_latency(jalv, port) &&
+        jalv->plugin_latency != port->control) {
+      jalv->plugin_latency = port->control;
+      jack_recompute_total_latencies(client);
+    }
+
+    if (port->flow == FLOW_OUTPUT && port->type == TYPE_EVENT) {
+      void* const buf =
+        port->sys_port ? jack_port_get_buffer(port->sys_port, nframes) : NULL;
+      jack_write_output_events(jalv, p, port->evbuf, buf, true);
+    } else if (send_ui_updates && port->flow == FLOW_OUTPUT &&
+               port->type == TYPE_CONTROL) {
+      jalv_send_control_output(jalv, p);
+    }
+  }
+
+  jack_update_fade(jalv, nframes);
+  jack_record_overhead(&jalv->backend->plan.stats, t0, run_time);
+  return 0;
+}
+
+/// DSP thread for pipelined execution, runs the plugin one period behind
+static REALTIME void*
+jack_dsp_thread(void* data)
+{
+  Jalv* const         jalv = (Jalv*)data;
+  JalvPipeline* const pipe = jalv->backend->pipeline;
+
+  while (!zix_sem_wait(&pipe->sem) && !JALV_ATOMIC_LOAD(&pipe->exit)) {
+    const uint64_t          t0      = jalv_clock_now();
+    JalvPipelineSlot* const slot    = &pipe->slots[pipe->dsp_slot];
+    const jack_nframes_t    nframes = pipe->nframes;
+
+    // Connect plugin to the buffers in this slot
+    for (uint32_t p = 0; p < jalv->num_ports; ++p) {
+      struct Port* const port = &jalv->ports[p];
+      if (slot->audio[p]) {
+        jalv_connect_audio_port(jalv, p, slot->audio[p]);
+      } else if (port->type == TYPE_EVENT && port->flow == FLOW_INPUT) {
+        lv2_evbuf_copy(port->evbuf, slot->events[p]);
+      } else if (port->type == TYPE_EVENT) {
+        lv2_evbuf_reset(port->evbuf, false);
+      }
+    }
+
+    // Run plugin for this cycle
+    const bool send_ui_updates = jalv_run(jalv, nframes);
+
+    // Collect outputs and send UI events
+    for (uint32_t p = 0; p < jalv->num_ports; ++p) {
+      struct Port* const port = &jalv->ports[p];
+      if (jack_port_reports_latency(jalv, port) &&
+          jalv->plugin_latency != port->control) {
         jalv->plugin_latency = port->control;
-        jack_recompute_total_latencies(client);
+        JALV_ATOMIC_STORE(&pipe->latency_changed, 1);
       }
-    } else if (port->flow == FLOW_OUTPUT && port->type == TYPE_EVENT) {
-      void* buf = NULL;
-      if (port->sys_port) {
-        buf = jack_port_get_buffer(port->sys_port, nframes);
-        jack_midi_clear_buffer(buf);
+
+      if (port->flow == FLOW_OUTPUT && port->type == TYPE_EVENT) {
+        // Keep events for the Jack thread, which writes them next period
+        lv2_evbuf_copy(slot->events[p], port->evbuf);
+        jack_write_output_events(jalv, p, port->evbuf, NULL, true);
+      } else if (send_ui_updates && port->flow == FLOW_OUTPUT &&
+                 port->type == TYPE_CONTROL) {
+        jalv_send_control_output(jalv, p);
       }
+    }
 
-      for (LV2_Evbuf_Iterator i = lv2_evbuf_begin(port->evbuf);
-           lv2_evbuf_is_valid(i);
-           i = lv2_evbuf_next(i)) {
-        // Get event from LV2 buffer
-        uint32_t frames    = 0;
-        uint32_t subframes = 0;
-        LV2_URID type      = 0;
-        uint32_t size      = 0;
-        void*    body      = NULL;
-        lv2_evbuf_get(i, &frames, &subframes, &type, &size, &body);
-
-        if (buf && type == jalv->urids.midi_MidiEvent) {
-          // Write MIDI event to Jack output
-          jack_midi_event_write(buf, frames, body, size);
-        }
+    const uint64_t dt = jalv_clock_now() - t0;
+    pipe->stats.run_last = dt;
+    pipe->stats.run_max  = dt > pipe->stats.run_max ? dt : pipe->stats.run_max;
+    pipe->stats.run_total += dt;
 
-        if (jalv->has_ui) {
-          // Forward event to UI
-          jalv_write_event(jalv, jalv->plugin_to_ui, p, size, type, body);
-        }
+    JALV_ATOMIC_STORE(&pipe->busy, 0);
+  }
+
+  return NULL;
+}
+
+/// Jack process callback for pipelined execution in the DSP thread
+static REALTIME int
+jack_process_pipelined_cb(jack_nframes_t nframes, void* data)
+{
+  Jalv* const         jalv = (Jalv*)data;
+  JalvPipeline* const pipe = jalv->backend->pipeline;
+  const uint64_t      t0   = jalv_clock_now();
+
+  if (!pipe->slots[0].audio) {
+    // Buffers failed to allocate for this buffer size, so the plugin can't run
+    jack_silence_outputs(jalv, nframes, NULL);
+    return 0;
+  }
+
+  if (JALV_ATOMIC_LOAD(&pipe->busy)) {
+    // DSP thread missed its deadline, drop this period
+    ++pipe->stats.misses;
+    jack_silence_outputs(jalv, nframes, NULL);
+    return 0;
+  }
+
+  if (JALV_ATOMIC_LOAD(&pipe->latency_changed)) {
+    JALV_ATOMIC_STORE(&pipe->latency_changed, 0);
+    jack_recompute_total_latencies(jalv->backend->client);
+  }
+
+  // The DSP thread is idle, so the plugin may be paused here
+  jack_mix_input_buses(jalv, nframes);
+  jack_read_control_inputs(jalv, nframes);
+  if (jack_check_paused(jalv, nframes)) {
+    return 0;
+  }
+
+  // Update transport only once the DSP thread is idle and the position will
+  // be delivered, so a dropped period is reported as a change in the next one
+  uint8_t               pos_buf[256];
+  const LV2_Atom* const lv2_pos =
+    jack_update_transport(jalv, nframes, pos_buf, sizeof(pos_buf));
+
+  // Outputs computed before a pause are stale, so pass through dry input
+  const bool stale = pipe->stale;
+  if (stale) {
+    jack_silence_outputs(jalv, nframes, jalv->backend->fade.dry_sources);
+  }
+
+  JalvPipelineSlot* const done = &pipe->slots[pipe->dsp_slot];
+  JalvPipelineSlot* const next = &pipe->slots[!pipe->dsp_slot];
+  for (uint32_t p = 0; p < jalv->num_ports; ++p) {
+    struct Port* const port = &jalv->ports[p];
+    if (jack_port_has_audio(jalv, p)) {
+      if (port->flow == FLOW_INPUT) {
+        memcpy(next->audio[p],
+               jack_audio_input(jalv, p, nframes),
+               nframes * sizeof(float));
+      } else if (!stale) {
+        memcpy(jack_port_get_buffer(port->sys_port, nframes),
+               done->audio[p],
+               nframes * sizeof(float));
       }
-    } else if (send_ui_updates && port->flow == FLOW_OUTPUT &&
-               port->type == TYPE_CONTROL) {
-      jalv_write_control(jalv, jalv->plugin_to_ui, p, port->control);
+    } else if (port->type == TYPE_EVENT && port->flow == FLOW_INPUT) {
+      jack_write_input_events(jalv, port, next->events[p], nframes, lv2_pos);
+    } else if (port->type == TYPE_EVENT && port->sys_port && !stale) {
+      void* const buf = jack_port_get_buffer(port->sys_port, nframes);
+      jack_write_output_events(jalv, p, done->events[p], buf, false);
     }
   }
+  jalv->request_update = false;
+  pipe->stale          = false;
+
+  if (!stale && jack_update_fade(jalv, nframes)) {
+    // Faded out and paused, so don't run the plugin again
+    pipe->stale = true;
+    return 0;
+  }
+
+  // Hand the next slot to the DSP thread
+  pipe->dsp_slot = !pipe->dsp_slot;
+  pipe->nframes  = nframes;
+  JALV_ATOMIC_STORE(&pipe->busy, 1);
+  zix_sem_post(&pipe->sem);
+
+  const uint64_t dt = jalv_clock_now() - t0;
+  ++pipe->stats.cycles;
+  pipe->stats.handoff_last = dt;
+  pipe->stats.handoff_max =
+    dt > pipe->stats.handoff_max ? dt : pipe->stats.handoff_max;
+  pipe->stats.handoff_total += dt;
 
   return 0;
 }
@@ -290,9 +1204,24 @@ jack_latency_cb(jack_latency_callback_mode_t mode, void* data)
     range.min = 0;
   }
 
-  // Add the plugin's own latency
-  range.min += jalv->plugin_latency;
-  range.max += jalv->plugin_latency;
+  // Add the plugin's own latency (which is at the plugin rate)
+  const JalvBackend* const backend = jalv->backend;
+  const uint32_t           factor =
+    backend ? backend->oversampling.factor : 1U;
+  range.min += jalv->plugin_latency / factor;
+  range.max += jalv->plugin_latency / factor;
+
+  if (factor > 1U) {
+    // Add the latency of the resampling filters
+    range.min += jalv_oversampler_latency(factor);
+    range.max += jalv_oversampler_latency(factor);
+  }
+
+  if (backend && backend->pipeline) {
+    // Pipelined execution adds a period of latency
+    range.min += jalv->block_length;
+    range.max += jalv->block_length;
+  }
 
   // Tell Jack about it
   for (uint32_t p = 0; p < jalv->num_ports; ++p) {
@@ -350,18 +1279,28 @@ jalv_backend_init(Jalv* jalv)
 
   jalv_log(JALV_LOG_INFO, "JACK Name:    %s\n", jack_get_client_name(client));
 
-  // Set audio engine properties
-  jalv->sample_rate   = (float)jack_get_sample_rate(client);
-  jalv->block_length  = jack_get_buffer_size(client);
+  // Determine the oversampling factor
+  uint32_t factor = 1U;
+  if (jalv->opts.oversample == 2 || jalv->opts.oversample == 4) {
+    factor = (uint32_t)jalv->opts.oversample;
+    jalv_log(JALV_LOG_INFO, "Oversampling: %ux\n", factor);
+  } else if (jalv->opts.oversample > 1) {
+    jalv_log(JALV_LOG_WARNING,
+             "Unsupported oversampling factor %d\n",
+             jalv->opts.oversample);
+  }
+
+  // Set audio engine properties (for the plugin, so possibly oversampled)
+  jalv->sample_rate   = (float)jack_get_sample_rate(client) * (float)factor;
+  jalv->block_length  = jack_get_buffer_size(client) * factor;
   jalv->midi_buf_size = 4096;
 #if USE_JACK_PORT_TYPE_GET_BUFFER_SIZE
   jalv->midi_buf_size =
     jack_port_type_get_buffer_size(client, JACK_DEFAULT_MIDI_TYPE);
 #endif
 
-  // Set JACK callbacks
+  // Set JACK callbacks (the process callback is set on activation)
   void* const arg = (void*)jalv;
-  jack_set_process_callback(client, &jack_process_cb, arg);
   jack_set_buffer_size_callback(client, &jack_buffer_size_cb, arg);
   jack_on_shutdown(client, &jack_shutdown_cb, arg);
   jack_set_latency_callback(client, &jack_latency_cb, arg);
@@ -369,20 +1308,215 @@ jalv_backend_init(Jalv* jalv)
   if (jalv->backend) {
     /* Internal JACK client, jalv->backend->is_internal_client was already set
        in jack_initialize() when allocating the backend. */
+    jalv->backend->oversampling.factor = factor;
     return jalv->backend;
   }
 
   // External JACK client, allocate and return opaque backend
-  JalvBackend* backend        = (JalvBackend*)calloc(1, sizeof(JalvBackend));
-  backend->client             = client;
-  backend->is_internal_client = false;
+  JalvBackend* backend         = (JalvBackend*)calloc(1, sizeof(JalvBackend));
+  backend->client              = client;
+  backend->is_internal_client  = false;
+  backend->oversampling.factor = factor;
   return backend;
 }
 
+/// Stop the DSP thread and free the pipeline, if any
+static void
+jack_pipeline_close(Jalv* const jalv)
+{
+  JalvPipeline* const pipe = jalv->backend->pipeline;
+  if (!pipe) {
+    return;
+  }
+
+  if (pipe->running) {
+    JALV_ATOMIC_STORE(&pipe->exit, 1);
+    zix_sem_post(&pipe->sem);
+    jack_client_stop_thread(jalv->backend->client, pipe->thread);
+    pipe->running = false;
+  }
+
+  jack_pipeline_free_buffers(jalv, pipe);
+  zix_sem_destroy(&pipe->sem);
+  free(pipe);
+  jalv->backend->pipeline = NULL;
+}
+
+/// Set up pipelined execution and start the DSP thread
+static int
+jack_pipeline_open(Jalv* const jalv)
+{
+  jack_client_t* const client = jalv->backend->client;
+  JalvPipeline* const  pipe = (JalvPipeline*)calloc(1, sizeof(JalvPipeline));
+  if (!pipe) {
+    return 1;
+  }
+
+  if (zix_sem_init(&pipe->sem, 0)) {
+    free(pipe);
+    return 1;
+  }
+
+  pipe->stale             = true;
+  jalv->backend->pipeline = pipe;
+  if (jack_pipeline_allocate(jalv, pipe)) {
+    jack_pipeline_close(jalv);
+    return 1;
+  }
+
+  // Run the DSP thread with the same priority as the Jack process thread
+  const int realtime = jack_is_realtime(client);
+  const int priority = realtime ? jack_client_real_time_priority(client) : 0;
+  if (jack_client_create_thread(
+        client, &pipe->thread, priority, realtime, jack_dsp_thread, jalv)) {
+    jack_pipeline_close(jalv);
+    return 1;
+  }
+
+  pipe->running = true;
+
+  if (jalv->opts.dsp_cpu >= 0) {
+#if USE_PTHREAD_SETAFFINITY_NP
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(jalv->opts.dsp_cpu, &cpus);
+    if (pthread_setaffinity_np(pipe->thread, sizeof(cpus), &cpus)) {
+      jalv_log(JALV_LOG_WARNING,
+               "Failed to pin DSP thread to CPU %d\n",
+               jalv->opts.dsp_cpu);
+    }
+#else
+    jalv_log(JALV_LOG_WARNING, "Pinning threads to CPUs is not supported\n");
+#endif
+  }
+
+  jalv_log(JALV_LOG_INFO, "Pipelined:    yes\n");
+  return 0;
+}
+
+/// Pair each audio output with the audio input in the same position, if any
+static void
+jack_pause_fade_init(Jalv* const jalv, JalvPauseFade* const fade)
+{
+  free(fade->dry_sources);
+  fade->dry_sources = (int32_t*)calloc(jalv->num_ports, sizeof(int32_t));
+  fade->gain        = 0.0f;
+  fade->step        = 1.0f / (JALV_PAUSE_FADE_TIME *
+                        (float)jack_get_sample_rate(jalv->backend->client));
+  if (!fade->dry_sources) {
+    return;
+  }
+
+  uint32_t next_input = 0U;
+  for (uint32_t p = 0; p < jalv->num_ports; ++p) {
+    const struct Port* const port = &jalv->ports[p];
+    fade->dry_sources[p]          = -1;
+    if (port->type == TYPE_AUDIO && port->flow == FLOW_OUTPUT &&
+        port->sys_port) {
+      // Find the next audio input with a Jack port
+      while (next_input < jalv->num_ports &&
+             (jalv->ports[next_input].type != TYPE_AUDIO ||
+              jalv->ports[next_input].flow != FLOW_INPUT ||
+              !jack_port_has_audio(jalv, next_input))) {
+        ++next_input;
+      }
+
+      if (next_input < jalv->num_ports) {
+        fade->dry_sources[p] = (int32_t)next_input++;
+      }
+    }
+  }
+}
+
+/// Free the port index arrays of the process plan
+static void
+jack_process_plan_free(JalvProcessPlan* const plan)
+{
+  free(plan->audio_ports);
+  free(plan->event_inputs);
+  free(plan->control_outputs);
+  plan->audio_ports     = NULL;
+  plan->event_inputs    = NULL;
+  plan->control_outputs = NULL;
+}
+
+/// Choose the most specialised process callback that supports the plugin
+static JackProcessCallback
+jack_process_plan_init(Jalv* const jalv, JalvProcessPlan* const plan)
+{
+  jack_process_plan_free(plan);
+  memset(plan, 0, sizeof(JalvProcessPlan));
+
+  plan->audio_ports     = (uint32_t*)calloc(jalv->num_ports, sizeof(uint32_t));
+  plan->event_inputs    = (uint32_t*)calloc(jalv->num_ports, sizeof(uint32_t));
+  plan->control_outputs = (uint32_t*)calloc(jalv->num_ports, sizeof(uint32_t));
+  plan->latency_port    = -1;
+  if (!plan->audio_ports || !plan->event_inputs || !plan->control_outputs) {
+    return &jack_process_cb;
+  }
+
+  bool has_event_outputs = false;
+  for (uint32_t p = 0; p < jalv->num_ports; ++p) {
+    const struct Port* const port = &jalv->ports[p];
+    if (jack_port_reports_latency(jalv, port)) {
+      plan->latency_port = (int32_t)p; // Also sent to the UI like any output
+    }
+
+    if (port->type == TYPE_CONTROL && port->flow == FLOW_OUTPUT &&
+        jalv->has_ui) {
+      plan->control_outputs[plan->n_control_outputs++] = p;
+    } else if ((port->type == TYPE_AUDIO || port->type == TYPE_CV) &&
+               port->sys_port) {
+      plan->audio_ports[plan->n_audio_ports++] = p;
+    } else if (port->type == TYPE_EVENT && port->flow == FLOW_INPUT) {
+      plan->event_inputs[plan->n_event_inputs++] = p;
+    } else if (port->type == TYPE_EVENT) {
+      has_event_outputs = true;
+    }
+  }
+
+  if (jalv->backend->oversampling.factor > 1U) {
+    plan->variant = JALV_PROCESS_OVERSAMPLED;
+    return &jack_process_oversampled_cb;
+  }
+
+  if (jalv->opts.generic_process || has_event_outputs) {
+    plan->variant = JALV_PROCESS_FULL;
+    return &jack_process_cb;
+  }
+
+  if (plan->n_event_inputs) {
+    plan->variant = JALV_PROCESS_SYNTH;
+    return &jack_process_synth_cb;
+  }
+
+  if (jalv->bpm_port_index >= 0) {
+    // The BPM port is set from transport, which only the full callback checks
+    plan->variant = JALV_PROCESS_FULL;
+    return &jack_process_cb;
+  }
+
+  plan->variant = JALV_PROCESS_AUDIO;
+  return &jack_process_audio_cb;
+}
+
 void
 jalv_backend_close(Jalv* jalv)
 {
   if (jalv->backend) {
+    jack_pipeline_close(jalv);
+    jack_process_plan_free(&jalv->backend->plan);
+    free(jalv->backend->fade.dry_sources);
+    free(jalv->backend->silence);
+    free(jalv->backend->scratch);
+    free(jalv->backend->control_inputs);
+    jack_oversampling_free(jalv, &jalv->backend->oversampling);
+    for (uint32_t b = 0U; b < jalv->backend->n_buses; ++b) {
+      free(jalv->backend->buses[b].sources);
+      free(jalv->backend->buses[b].gains);
+      jalv_dsp_free(jalv->backend->buses[b].buffer);
+    }
+    free(jalv->backend->buses);
     if (!jalv->backend->is_internal_client) {
       jack_client_close(jalv->backend->client);
     }
@@ -395,7 +1529,44 @@ jalv_backend_close(Jalv* jalv)
 void
 jalv_backend_activate(Jalv* jalv)
 {
-  jack_activate(jalv->backend->client);
+  jack_client_t* const client = jalv->backend->client;
+
+  if (jack_connect_hidden_ports(jalv)) {
+    jalv_log(JALV_LOG_ERR, "Failed to allocate hidden port buffers\n");
+  }
+
+  if (jack_connect_input_buses(jalv)) {
+    jalv_log(JALV_LOG_ERR, "Failed to allocate input bus buffers\n");
+  }
+
+  JalvOversampling* const os = &jalv->backend->oversampling;
+  if (jack_oversampling_init(jalv, os)) {
+    jalv_log(JALV_LOG_ERR, "Failed to allocate oversampling buffers\n");
+    jack_oversampling_free(jalv, os);
+    os->factor = 1U;
+  } else if (os->factor > 1U && jalv->opts.pipelined) {
+    jalv_log(JALV_LOG_WARNING,
+             "Pipelining is not supported when oversampling\n");
+    jalv->opts.pipelined = false;
+  }
+
+  jack_pause_fade_init(jalv, &jalv->backend->fade);
+  if (jalv->opts.pipelined && !jack_pipeline_open(jalv)) {
+    jack_set_process_callback(client, &jack_process_pipelined_cb, jalv);
+  } else {
+    if (jalv->opts.pipelined) {
+      jalv_log(JALV_LOG_ERR, "Failed to start DSP thread\n");
+    }
+
+    JalvProcessPlan* const    plan    = &jalv->backend->plan;
+    const JackProcessCallback process = jack_process_plan_init(jalv, plan);
+    jalv_log(JALV_LOG_INFO,
+             "Process:      %s\n",
+             jack_process_variant_names[plan->variant]);
+    jack_set_process_callback(client, process, jalv);
+  }
+
+  jack_activate(client);
 }
 
 void
@@ -403,7 +1574,249 @@ jalv_backend_deactivate(Jalv* jalv)
 {
   if (jalv->backend && !jalv->backend->is_internal_client) {
     jack_deactivate(jalv->backend->client);
+    jack_pipeline_close(jalv);
+  }
+}
+
+int
+jalv_backend_set_input_gain(Jalv*    jalv,
+                            uint32_t port_index,
+                            uint32_t source,
+                            float    gain)
+{
+  JalvInputBus* const bus = jack_find_bus(jalv->backend, port_index);
+  if (!bus || source >= bus->n_sources) {
+    return 1;
+  }
+
+  bus->gains[source] = gain;
+  return 0;
+}
+
+bool
+jalv_backend_has_control_input(Jalv* const jalv, const uint32_t port_index)
+{
+  for (uint32_t i = 0U; i < jalv->backend->n_control_inputs; ++i) {
+    if (jalv->backend->control_inputs[i].port_index == port_index) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void
+jalv_backend_print_stats(Jalv* jalv, FILE* stream)
+{
+  const JalvPipeline* const pipe = jalv->backend->pipeline;
+  if (!pipe) {
+    const JalvProcessPlan* const  plan   = &jalv->backend->plan;
+    const JalvProcessStats* const stats  = &plan->stats;
+    const double                  cycles = stats->cycles ? stats->cycles : 1;
+
+    fprintf(stream, "Pipelined:    no\n");
+    fprintf(stream,
+            "Process:      %s\n",
+            jack_process_variant_names[plan->variant]);
+    fprintf(stream, "Cycles:       %" PRIu64 "\n", stats->cycles);
+    fprintf(stream,
+            "Overhead:     %.2f us last, %.2f us mean, %.2f us max\n",
+            stats->overhead_last / 1000.0,
+            stats->overhead_total / cycles / 1000.0,
+            stats->overhead_max / 1000.0);
+    return;
+  }
+
+  const JalvPipelineStats* const stats  = &pipe->stats;
+  const double                   cycles = stats->cycles ? stats->cycles : 1;
+
+  fprintf(stream, "Pipelined:    yes\n");
+  fprintf(stream, "Cycles:       %" PRIu64 "\n", stats->cycles);
+  fprintf(stream, "Misses:       %" PRIu64 "\n", stats->misses);
+  fprintf(stream,
+          "Handoff:      %.1f us last, %.1f us mean, %.1f us max\n",
+          stats->handoff_last / 1000.0,
+          stats->handoff_total / cycles / 1000.0,
+          stats->handoff_max / 1000.0);
+  fprintf(stream,
+          "DSP run:      %.1f us last, %.1f us mean, %.1f us max\n",
+          stats->run_last / 1000.0,
+          stats->run_total / cycles / 1000.0,
+          stats->run_max / 1000.0);
+}
+
+/// Return true iff `pattern` matches `str`, where `*` and `?` are wildcards
+static bool
+jack_pattern_matches(const char* pattern, const char* str)
+{
+  for (; *pattern; ++pattern, ++str) {
+    if (*pattern == '*') {
+      // Try to match the rest of the pattern at every remaining position
+      for (; *str; ++str) {
+        if (jack_pattern_matches(pattern + 1, str)) {
+          return true;
+        }
+      }
+      return jack_pattern_matches(pattern + 1, str);
+    }
+
+    if (!*str || (*pattern != '?' && *pattern != *str)) {
+      return false;
+    }
+  }
+
+  return !*str;
+}
+
+/// Return the number of sources to mix into an input port, or 0 for none
+static uint32_t
+jack_port_n_bus_sources(const Jalv* const jalv, const struct Port* const port)
+{
+  if (!jalv->opts.input_buses || port->type != TYPE_AUDIO ||
+      port->flow != FLOW_INPUT) {
+    return 0U;
+  }
+
+  const char* const sym = lilv_node_as_string(
+    lilv_port_get_symbol(jalv->plugin, port->lilv_port));
+  const size_t sym_len = strlen(sym);
+  for (char** b = jalv->opts.input_buses; *b; ++b) {
+    // Parse SYMBOL=N
+    if (!strncmp(*b, sym, sym_len) && (*b)[sym_len] == '=') {
+      const int n = atoi(*b + sym_len + 1);
+      return n > 0 ? (uint32_t)n : 0U;
+    }
+  }
+
+  return 0U;
+}
+
+/// Register the Jack ports of an input bus for a plugin input port
+static int
+jack_register_input_bus(Jalv* const     jalv,
+                        const uint32_t  port_index,
+                        const char*     sym,
+                        const uint32_t  n_sources)
+{
+  JalvBackend* const  backend = jalv->backend;
+  JalvInputBus* const buses   = (JalvInputBus*)realloc(
+    backend->buses, (backend->n_buses + 1U) * sizeof(JalvInputBus));
+  if (!buses) {
+    return 1;
+  }
+
+  JalvInputBus* const bus = &buses[backend->n_buses];
+  backend->buses          = buses;
+  bus->port_index         = port_index;
+  bus->n_sources          = 0U;
+  bus->sources = (jack_port_t**)calloc(n_sources, sizeof(jack_port_t*));
+  bus->gains   = (float*)calloc(n_sources, sizeof(float));
+  bus->buffer  = NULL;
+  ++backend->n_buses;
+  if (!bus->sources || !bus->gains) {
+    return 1;
+  }
+
+  // Register ports named like "in_1", "in_2", and so on
+  const size_t name_len = strlen(sym) + 12U;
+  char* const  name     = (char*)calloc(1, name_len);
+  if (!name) {
+    return 1;
+  }
+
+  for (uint32_t i = 0U; i < n_sources; ++i) {
+    snprintf(name, name_len, "%s_%u", sym, i + 1U);
+    bus->sources[i] = jack_port_register(
+      backend->client, name, JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
+    if (!bus->sources[i]) {
+      break;
+    }
+
+    bus->gains[i] = 1.0f;
+    ++bus->n_sources;
+  }
+
+  free(name);
+  return bus->n_sources == n_sources ? 0 : 1;
+}
+
+/// Return true iff a control port has its own audio input
+static bool
+jack_port_has_control_input(const Jalv* const        jalv,
+                            const struct Port* const port)
+{
+  if (!jalv->opts.control_inputs || port->flow != FLOW_INPUT) {
+    return false;
+  }
+
+  const char* const sym = lilv_node_as_string(
+    lilv_port_get_symbol(jalv->plugin, port->lilv_port));
+  for (char** c = jalv->opts.control_inputs; *c; ++c) {
+    if (!strcmp(*c, sym)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/// Register a Jack audio input named like a control port, to modulate it
+static int
+jack_register_control_input(Jalv* const    jalv,
+                            const uint32_t port_index,
+                            const char*    sym)
+{
+  JalvBackend* const      backend = jalv->backend;
+  JalvControlInput* const inputs  = (JalvControlInput*)realloc(
+    backend->control_inputs,
+    (backend->n_control_inputs + 1U) * sizeof(JalvControlInput));
+  if (!inputs) {
+    return 1;
+  }
+
+  backend->control_inputs = inputs;
+
+  jack_port_t* const port = jack_port_register(
+    backend->client, sym, JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
+  if (!port) {
+    return 1;
+  }
+
+#if USE_JACK_METADATA
+  jack_set_property(backend->client,
+                    jack_port_uuid(port),
+                    "http://jackaudio.org/metadata/signal-type",
+                    "CV",
+                    "text/plain");
+#endif
+
+  inputs[backend->n_control_inputs].port_index = port_index;
+  inputs[backend->n_control_inputs].port       = port;
+  ++backend->n_control_inputs;
+  return 0;
+}
+
+/// Return true iff a port should be registered with Jack
+static bool
+jack_port_is_exposed(const Jalv* const jalv, const struct Port* const port)
+{
+  if (jalv->opts.hide_optional &&
+      lilv_port_has_property(
+        jalv->plugin, port->lilv_port, jalv->nodes.lv2_connectionOptional)) {
+    return false;
+  }
+
+  if (jalv->opts.hidden_ports) {
+    const char* const sym = lilv_node_as_string(
+      lilv_port_get_symbol(jalv->plugin, port->lilv_port));
+    for (char** h = jalv->opts.hidden_ports; *h; ++h) {
+      if (jack_pattern_matches(*h, sym)) {
+        return false;
+      }
+    }
   }
+
+  return true;
 }
 
 void
@@ -420,6 +1833,24 @@ jalv_backend_activate_port(Jalv* jalv, uint32_t port_index)
     return;
   }
 
+  // Leave hidden ports unregistered (connected to host buffers on activation)
+  if (port->type != TYPE_CONTROL && !jack_port_is_exposed(jalv, port)) {
+    jalv_log(JALV_LOG_INFO, "Hiding port:  %s\n", lilv_node_as_string(sym));
+    return;
+  }
+
+  // Register several ports to be mixed for an input bus
+  const uint32_t n_bus_sources = jack_port_n_bus_sources(jalv, port);
+  if (n_bus_sources) {
+    if (jack_register_input_bus(
+          jalv, port_index, lilv_node_as_string(sym), n_bus_sources)) {
+      jalv_log(JALV_LOG_ERR,
+               "Failed to register input bus for %s\n",
+               lilv_node_as_string(sym));
+    }
+    return;
+  }
+
   // Build Jack flags for port
   enum JackPortFlags jack_flags =
     (port->flow == FLOW_INPUT) ? JackPortIsInput : JackPortIsOutput;
@@ -428,6 +1859,13 @@ jalv_backend_activate_port(Jalv* jalv, uint32_t port_index)
   switch (port->type) {
   case TYPE_CONTROL:
     lilv_instance_connect_port(jalv->instance, port_index, &port->control);
+    if (jack_port_has_control_input(jalv, port) &&
+        jack_register_control_input(
+          jalv, port_index, lilv_node_as_string(sym))) {
+      jalv_log(JALV_LOG_ERR,
+               "Failed to register control input for %s\n",
+               lilv_node_as_string(sym));
+    }
     break;
   case TYPE_AUDIO:
     port->sys_port = jack_port_register(
@@ -1,7 +1,10 @@
 // Copyright 2007-2022 David Robillard <d@drobilla.net>
 // SPDX-License-Identifier: ISC
 
+#include "atomic.h"
 #include "backend.h"
+#include "clock.h"
+#include "command.h"
 #include "control.h"
 #include "frontend.h"
 #include "jalv_config.h"
@@ -11,9 +14,11 @@
 #include "nodes.h"
 #include "options.h"
 #include "port.h"
+#include "ring.h"
 #include "state.h"
 #include "types.h"
 #include "urids.h"
+#include "wakeup.h"
 #include "worker.h"
 
 #include "lilv/lilv.h"
@@ -44,6 +49,7 @@
 #include "zix/attributes.h"
 #include "zix/ring.h"
 #include "zix/sem.h"
+#include "zix/thread.h"
 
 #if USE_SUIL
 #  include "suil/suil.h"
@@ -82,10 +88,19 @@
 #  define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
 #endif
 
+/// Default UI update rate of latency outputs, which rarely change
+#define LATENCY_UPDATE_HZ 2.0f
+
+/// Fraction of the range of an output control that is a significant change
+#define CONTROL_RESOLUTION 1.0e-4f
+
 #ifndef MSG_BUFFER_SIZE
 #  define MSG_BUFFER_SIZE 1024
 #endif
 
+/// Maximum number of values in a batch, which is sent as a single message
+#define MAX_BATCH_SIZE (MSG_BUFFER_SIZE / sizeof(ControlValue))
+
 /**
    Size factor for UI ring buffers.
 
@@ -96,7 +111,11 @@
 */
 #define N_BUFFER_CYCLES 16
 
-static ZixSem* exit_sem = NULL; ///< Exit semaphore used by signal handler
+/// Size of the UI priority ring, which only holds a few small messages
+#define PRIORITY_RING_SIZE (4U * (MSG_BUFFER_SIZE + 16U))
+
+static ZixSem*     exit_sem    = NULL; ///< Exit semaphore for signal handler
+static JalvWakeup* exit_wakeup = NULL; ///< UI wakeup for signal handler
 
 /**
    Fix symbol names to match LV2 spec, i.e. a-z A-Z _ 0-9 (except for first char)
@@ -205,6 +224,59 @@ die(const char* msg)
   exit(EXIT_FAILURE);
 }
 
+/// Return true if a control port only has integer values
+static bool
+control_is_discrete(Jalv* const jalv, const LilvPort* const lilv_port)
+{
+  const LilvPlugin* const plugin = jalv->plugin;
+
+  return lilv_port_has_property(plugin, lilv_port, jalv->nodes.lv2_toggled) ||
+         lilv_port_has_property(plugin, lilv_port, jalv->nodes.lv2_integer) ||
+         lilv_port_has_property(plugin, lilv_port, jalv->nodes.lv2_enumeration);
+}
+
+/// Return the smallest change of a control port that is sent to the UI
+static float
+control_epsilon(Jalv* const           jalv,
+                const LilvPort* const lilv_port,
+                const float           min,
+                const float           max)
+{
+  if (control_is_discrete(jalv, lilv_port)) {
+    return 0.5f; // Any real change is at least 1
+  }
+
+  // Send every change if the range is unknown
+  return (isnan(min) || isnan(max)) ? 0.0f
+                                    : fabsf(max - min) * CONTROL_RESOLUTION;
+}
+
+/// Return how to reduce the values of an output control between UI updates
+static enum PortAggregate
+default_aggregate(Jalv* const jalv, const struct Port* const port)
+{
+  static const char* const meter_words[] = {"meter", "peak", "level", "vu"};
+
+  const LilvPlugin* const plugin = jalv->plugin;
+  if (port->flow != FLOW_OUTPUT || port->type != TYPE_CONTROL ||
+      control_is_discrete(jalv, port->lilv_port) ||
+      lilv_port_has_property(
+        plugin, port->lilv_port, jalv->nodes.lv2_reportsLatency)) {
+    return AGGREGATE_LAST;
+  }
+
+  // Show the peak of meters, since they are often sampled between peaks
+  const char* const symbol =
+    lilv_node_as_string(lilv_port_get_symbol(plugin, port->lilv_port));
+  for (size_t i = 0U; i < ARRAY_SIZE(meter_words); ++i) {
+    if (strstr(symbol, meter_words[i])) {
+      return AGGREGATE_MAX;
+    }
+  }
+
+  return AGGREGATE_LAST;
+}
+
 /**
    Create a port structure from data description.
 
@@ -222,6 +294,13 @@ create_port(Jalv* jalv, uint32_t port_index, float default_value)
   port->buf_size  = 0;
   port->index     = port_index;
   port->control   = 0.0f;
+  port->epsilon   = 0.0f;
+  port->sent      = NAN;
+  port->peak      = NAN;
+  port->aggregate = AGGREGATE_LAST;
+  port->rate      = 0.0f;
+  port->period    = 0U;
+  port->due       = 0U;
   port->flow      = FLOW_UNKNOWN;
 
   const bool optional = lilv_port_has_property(
@@ -291,10 +370,18 @@ jalv_create_ports(Jalv* jalv)
   jalv->ports     = (struct Port*)calloc(jalv->num_ports, sizeof(struct Port));
   float* default_values =
     (float*)calloc(lilv_plugin_get_num_ports(jalv->plugin), sizeof(float));
-  lilv_plugin_get_port_ranges_float(jalv->plugin, NULL, NULL, default_values);
+  float* min_values = (float*)calloc(jalv->num_ports, sizeof(float));
+  float* max_values = (float*)calloc(jalv->num_ports, sizeof(float));
+  lilv_plugin_get_port_ranges_float(
+    jalv->plugin, min_values, max_values, default_values);
 
   for (uint32_t i = 0; i < jalv->num_ports; ++i) {
     create_port(jalv, i, default_values[i]);
+    if (jalv->ports[i].type == TYPE_CONTROL) {
+      jalv->ports[i].epsilon = control_epsilon(
+        jalv, jalv->ports[i].lilv_port, min_values[i], max_values[i]);
+      jalv->ports[i].aggregate = default_aggregate(jalv, &jalv->ports[i]);
+    }
   }
 
   const LilvPort* control_input = lilv_plugin_get_port_by_designation(
@@ -310,6 +397,18 @@ jalv_create_ports(Jalv* jalv)
     }
   }
 
+  jalv->enabled_port_index = -1;
+  const LilvPort* const enabled_input = lilv_plugin_get_port_by_designation(
+    jalv->plugin, jalv->nodes.lv2_InputPort, jalv->nodes.lv2_enabled);
+  if (enabled_input) {
+    const uint32_t index = lilv_port_get_index(jalv->plugin, enabled_input);
+    if (jalv->ports[index].type == TYPE_CONTROL) {
+      jalv->enabled_port_index = (int32_t)index;
+    }
+  }
+
+  free(max_values);
+  free(min_values);
   free(default_values);
 }
 
@@ -323,6 +422,7 @@ jalv_allocate_port_buffers(Jalv* jalv)
   const LV2_URID atom_Sequence = jalv->map.map(
     jalv->map.handle, lilv_node_as_string(jalv->nodes.atom_Sequence));
 
+  size_t max_size = 0U;
   for (uint32_t i = 0; i < jalv->num_ports; ++i) {
     struct Port* const port = &jalv->ports[i];
     if (port->type == TYPE_EVENT) {
@@ -330,6 +430,7 @@ jalv_allocate_port_buffers(Jalv* jalv)
 
       const size_t size = port->buf_size ? port->buf_size : jalv->midi_buf_size;
 
+      max_size    = MAX(max_size, size);
       port->evbuf = lv2_evbuf_new(size, atom_Chunk, atom_Sequence);
 
       lilv_instance_connect_port(
@@ -338,6 +439,10 @@ jalv_allocate_port_buffers(Jalv* jalv)
       lv2_evbuf_reset(port->evbuf, port->flow == FLOW_INPUT);
     }
   }
+
+  // Allocate a buffer large enough to filter the events of any port
+  free(jalv->ui_seq_buf);
+  jalv->ui_seq_buf = max_size ? malloc(max_size) : NULL;
 }
 
 /**
@@ -362,6 +467,235 @@ jalv_port_by_symbol(Jalv* jalv, const char* sym)
   return NULL;
 }
 
+/// Create the output stage and its controls, pairing outputs with inputs
+static int
+jalv_create_stage(Jalv* const jalv)
+{
+  if (!(jalv->stage = jalv_stage_new(jalv->num_ports, jalv->sample_rate))) {
+    return 1;
+  }
+
+  // Mix the Nth audio output with the Nth audio input, if there is one
+  uint32_t input = 0U;
+  for (uint32_t i = 0U; i < jalv->num_ports; ++i) {
+    const struct Port* const output = &jalv->ports[i];
+    if (output->type != TYPE_AUDIO || output->flow != FLOW_OUTPUT) {
+      continue;
+    }
+
+    while (input < jalv->num_ports && (jalv->ports[input].type != TYPE_AUDIO ||
+                                       jalv->ports[input].flow != FLOW_INPUT)) {
+      ++input;
+    }
+
+    const uint32_t dry =
+      input < jalv->num_ports ? input++ : JALV_STAGE_NO_INPUT;
+    if (jalv_stage_add_channel(jalv->stage, i, dry)) {
+      return 1;
+    }
+  }
+
+  // Silence CV outputs when the plugin doesn't run, rather than mixing them
+  for (uint32_t i = 0U; i < jalv->num_ports; ++i) {
+    const struct Port* const output = &jalv->ports[i];
+    if (output->type == TYPE_CV && output->flow == FLOW_OUTPUT &&
+        jalv_stage_add_output(jalv->stage, i)) {
+      return 1;
+    }
+  }
+
+  if (jalv_stage_n_channels(jalv->stage) || jalv->enabled_port_index >= 0) {
+    ControlID* const bypass = new_host_control(jalv->world,
+                                               JALV_STAGE_BYPASS,
+                                               "jalv_bypass",
+                                               "Bypass",
+                                               0.0f,
+                                               1.0f,
+                                               0.0f,
+                                               &jalv->forge);
+
+    bypass->is_toggle = true;
+    add_control(&jalv->controls, bypass);
+  }
+
+  if (!jalv->opts.output_stage) {
+    return 0;
+  }
+
+  jalv_log(JALV_LOG_INFO,
+           "Output stage: %u channels\n",
+           jalv_stage_n_channels(jalv->stage));
+
+  add_control(&jalv->controls,
+              new_host_control(jalv->world,
+                               JALV_STAGE_WET,
+                               "jalv_wet",
+                               "Dry/Wet",
+                               0.0f,
+                               1.0f,
+                               1.0f,
+                               &jalv->forge));
+
+  add_control(&jalv->controls,
+              new_host_control(jalv->world,
+                               JALV_STAGE_GAIN,
+                               "jalv_gain",
+                               "Output Gain (dB)",
+                               -60.0f,
+                               24.0f,
+                               0.0f,
+                               &jalv->forge));
+
+  return 0;
+}
+
+/// Create meters for all audio ports
+static int
+jalv_create_meters(Jalv* const jalv)
+{
+  uint32_t* const ports =
+    (uint32_t*)calloc(jalv->num_ports + 1U, sizeof(uint32_t));
+  if (!ports) {
+    return 1;
+  }
+
+  uint32_t n_meters = 0U;
+  for (uint32_t i = 0U; i < jalv->num_ports; ++i) {
+    if (jalv->ports[i].type == TYPE_AUDIO) {
+      ports[n_meters++] = i;
+    }
+  }
+
+  jalv->meters = jalv_meters_new(ports,
+                                 n_meters,
+                                 jalv->num_ports,
+                                 jalv->sample_rate,
+                                 (float)jalv->opts.meter_rate,
+                                 jalv->opts.loudness);
+
+  jalv_log(JALV_LOG_INFO,
+           "Meter rate:   %.01f Hz (%u ports)\n",
+           jalv->opts.meter_rate,
+           n_meters);
+
+  free(ports);
+  return !jalv->meters;
+}
+
+/// Log when the watchdog trips or recovers
+static void
+jalv_report_watchdog(Jalv* const jalv)
+{
+  JalvWatchdogStatus status;
+  jalv_watchdog_status(jalv->watchdog, &status);
+  if (status.n_trips != jalv->watchdog_status.n_trips) {
+    jalv_log(JALV_LOG_WARNING,
+             "Plugin overran %u cycles, bypassing for %.1f s\n",
+             status.trip_cycles,
+             status.backoff / 1.0e9);
+  }
+  if (!status.tripped && jalv->watchdog_status.tripped) {
+    jalv_log(JALV_LOG_INFO, "Plugin resumed after overrun\n");
+  }
+  jalv->watchdog_status = status;
+}
+
+/// Watchdog reporter thread, which sleeps until a trip and polls to recovery
+static void*
+jalv_watchdog_func(void* const data)
+{
+  Jalv* const jalv = (Jalv*)data;
+
+  while (!JALV_ATOMIC_LOAD(&jalv->watchdog_exit)) {
+    if (jalv->watchdog_status.tripped) {
+      zix_sem_timed_wait(&jalv->watchdog_sem, 0U, 100000000U);
+    } else {
+      zix_sem_wait(&jalv->watchdog_sem);
+    }
+
+    jalv_report_watchdog(jalv);
+  }
+
+  return NULL;
+}
+
+/// Create a watchdog from an option like "FRACTION:CYCLES:SECONDS"
+static int
+jalv_create_watchdog(Jalv* const jalv)
+{
+  float    threshold   = 0.0f;
+  uint32_t trip_cycles = 4U;
+  double   backoff     = 1.0;
+  if (sscanf(jalv->opts.watchdog,
+             "%f:%u:%lf",
+             &threshold,
+             &trip_cycles,
+             &backoff) < 1 ||
+      threshold <= 0.0f || backoff < 0.0) {
+    jalv_log(
+      JALV_LOG_ERR, "Invalid watchdog setting `%s'\n", jalv->opts.watchdog);
+    return 1;
+  }
+
+  if (!(jalv->watchdog = jalv_watchdog_new(threshold, trip_cycles, backoff))) {
+    return 1;
+  }
+
+  // Report trips from a thread so they're seen with or without a UI
+  if (zix_sem_init(&jalv->watchdog_sem, 0)) {
+    jalv_watchdog_free(jalv->watchdog);
+    jalv->watchdog = NULL;
+    return 1;
+  }
+
+  if (zix_thread_create(
+        &jalv->watchdog_thread, 4096U, jalv_watchdog_func, jalv)) {
+    zix_sem_destroy(&jalv->watchdog_sem);
+    jalv_watchdog_free(jalv->watchdog);
+    jalv->watchdog = NULL;
+    return 1;
+  }
+
+  jalv_log(JALV_LOG_INFO,
+           "Watchdog:     %.0f%% of period for %u cycles, %.1f s back-off\n",
+           threshold * 100.0,
+           trip_cycles,
+           backoff);
+
+  return 0;
+}
+
+/// Create scope taps from options like "SYMBOL=LENGTH:DECIMATION"
+static int
+jalv_create_scope(Jalv* const jalv)
+{
+  if (!(jalv->scope = jalv_scope_new(jalv->num_ports))) {
+    return 1;
+  }
+
+  for (char** t = jalv->opts.scope_taps; *t; ++t) {
+    char     sym[256];
+    uint32_t length     = 1024U;
+    uint32_t decimation = 1U;
+    if (sscanf(*t, "%255[^=]=%u:%u", sym, &length, &decimation) < 1) {
+      jalv_log(JALV_LOG_WARNING, "Ignoring invalid scope tap `%s'\n", *t);
+      continue;
+    }
+
+    const struct Port* const port = jalv_port_by_symbol(jalv, sym);
+    if (!port || (port->type != TYPE_AUDIO && port->type != TYPE_CV)) {
+      jalv_log(JALV_LOG_WARNING, "Ignoring scope tap on `%s'\n", sym);
+      continue;
+    }
+
+    if (jalv_scope_add_tap(jalv->scope, port->index, length, decimation)) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
 ControlID*
 jalv_control_by_symbol(Jalv* jalv, const char* sym)
 {
@@ -439,8 +773,20 @@ jalv_set_control(Jalv*            jalv,
                  const void*      body)
 {
   if (control->type == PORT && type == jalv->forge.Float) {
-    struct Port* port = &jalv->ports[control->index];
-    port->control     = *(const float*)body;
+    jalv_write_control(
+      jalv, jalv->ui_to_plugin, control->index, *(const float*)body);
+  } else if (control->type == HOST && type == jalv->forge.Float) {
+    const float value = *(const float*)body;
+    if (control->index == JALV_STAGE_BYPASS && jalv->enabled_port_index >= 0) {
+      // Let the plugin bypass itself via its lv2:enabled port
+      jalv_write_control(jalv,
+                         jalv->ui_to_plugin,
+                         (uint32_t)jalv->enabled_port_index,
+                         value >= 0.5f ? 0.0f : 1.0f);
+    } else {
+      jalv_stage_set_control(
+        jalv->stage, (JalvStageControl)control->index, value);
+    }
   } else if (control->type == PROPERTY) {
     // Copy forge since it is used by process thread
     LV2_Atom_Forge       forge = jalv->forge;
@@ -464,6 +810,45 @@ jalv_set_control(Jalv*            jalv,
   }
 }
 
+float
+jalv_control_value(const Jalv* const jalv, const ControlID* const control)
+{
+  if (control->type == PORT) {
+    return jalv->ports[control->index].control;
+  }
+
+  if (control->type == HOST && control->index == JALV_STAGE_BYPASS &&
+      jalv->enabled_port_index >= 0) {
+    return jalv->ports[jalv->enabled_port_index].control == 0.0f ? 1.0f : 0.0f;
+  }
+
+  if (control->type == HOST) {
+    return jalv_stage_control(jalv->stage, (JalvStageControl)control->index);
+  }
+
+  return 0.0f;
+}
+
+void
+jalv_connect_audio_port(Jalv* const    jalv,
+                        const uint32_t port_index,
+                        void* const    buf)
+{
+  lilv_instance_connect_port(jalv->instance, port_index, buf);
+  if (jalv->stage) {
+    jalv_stage_connect(jalv->stage, port_index, buf);
+  }
+  if (jalv->meters) {
+    jalv_meters_connect(jalv->meters, port_index, buf);
+  }
+  if (jalv->modulators) {
+    jalv_modulators_connect(jalv->modulators, port_index, buf);
+  }
+  if (jalv->scope) {
+    jalv_scope_connect(jalv->scope, port_index, buf);
+  }
+}
+
 #if USE_SUIL
 static uint32_t
 jalv_ui_port_index(void* const controller, const char* symbol)
@@ -610,49 +995,250 @@ jalv_send_to_plugin(void* const jalv_handle,
   }
 }
 
-void
-jalv_apply_ui_events(Jalv* jalv, uint32_t nframes)
+/// Set the value of a control port from the UI (realtime safe)
+static void
+jalv_apply_control(void* const handle, const uint32_t index, const float value)
 {
-  if (!jalv->has_ui) {
-    return;
+  ((Jalv*)handle)->ports[index].control = value;
+}
+
+/**
+   Return the frame in this cycle of an event sent to the plugin.
+
+   Events sent during the previous cycle are placed at the same offset in this
+   one, so they all arrive with a latency of one cycle rather than jittering.
+*/
+static uint32_t
+jalv_event_frame(const Jalv* const jalv,
+                 const uint64_t    time,
+                 const uint32_t    nframes)
+{
+  const uint64_t start = jalv->cycle_last;
+  const uint64_t end   = jalv->cycle_start;
+  if (!nframes || !start || time <= start) {
+    return 0U;
   }
 
-  ControlChange ev    = {0U, 0U, 0U};
-  const size_t  space = zix_ring_read_space(jalv->ui_to_plugin);
-  for (size_t i = 0; i < space; i += sizeof(ev) + ev.size) {
-    if (zix_ring_read(jalv->ui_to_plugin, &ev, sizeof(ev)) != sizeof(ev)) {
-      jalv_log(JALV_LOG_ERR, "Failed to read header from UI ring buffer\n");
-      break;
-    }
+  return time < end ? (uint32_t)((time - start) * nframes / (end - start))
+                    : nframes - 1U;
+}
+
+/**
+   Apply events from a UI ring (realtime safe).
 
+   Events are read until at least `budget` bytes have been read, so that a
+   flood of large events only costs a bounded amount of time per cycle.
+*/
+static void
+jalv_apply_ring_events(Jalv* const     jalv,
+                       JalvRing* const ring,
+                       const uint32_t  nframes,
+                       const uint32_t  budget)
+{
+  ZixRing* const zring  = jalv_ring_begin_read(ring);
+  ControlChange  ev     = {0U, 0U, 0U};
+  uint32_t       n_read = 0U;
+  while (n_read < budget &&
+         zix_ring_read(zring, &ev, sizeof(ev)) == sizeof(ev)) {
     struct {
-      union {
-        LV2_Atom atom;
-        float    control;
-      } head;
-      uint8_t body[MSG_BUFFER_SIZE];
+      LV2_Atom atom;
+      uint8_t  body[MSG_BUFFER_SIZE];
     } buffer;
 
-    if (zix_ring_read(jalv->ui_to_plugin, &buffer, ev.size) != ev.size) {
+    n_read += (uint32_t)sizeof(ev) + ev.size;
+    if (ev.size > sizeof(buffer)) {
+      jalv_log(JALV_LOG_ERR, "Dropped %u byte UI event\n", ev.size);
+      zix_ring_skip(zring, ev.size);
+      continue;
+    }
+
+    if (zix_ring_read(zring, &buffer, ev.size) != ev.size) {
       jalv_log(JALV_LOG_ERR, "Failed to read from UI ring buffer\n");
       break;
     }
 
+    // Single control values are sent through the control channel instead
     assert(ev.index < jalv->num_ports);
+    assert(ev.protocol != 0U);
     struct Port* const port = &jalv->ports[ev.index];
-    if (ev.protocol == 0) {
-      assert(ev.size == sizeof(float));
-      port->control = buffer.head.control;
+    if (ev.protocol == jalv->urids.jalv_ControlBatch) {
+      const ControlValue* const values = (const ControlValue*)&buffer;
+      const uint32_t            n      = ev.size / sizeof(ControlValue);
+      for (uint32_t v = 0U; v < n; ++v) {
+        jalv->ports[values[v].index].control = values[v].value;
+        if (jalv->has_ui) {
+          // Update UI (as if from plugin)
+          jalv_write_control(
+            jalv, jalv->plugin_to_ui, values[v].index, values[v].value);
+        }
+      }
+      JALV_ATOMIC_ADD(&jalv->batches_done, 1);
     } else if (ev.protocol == jalv->urids.atom_eventTransfer) {
-      LV2_Evbuf_Iterator    e    = lv2_evbuf_end(port->evbuf);
-      const LV2_Atom* const atom = &buffer.head.atom;
-      lv2_evbuf_write(
-        &e, nframes, 0, atom->type, atom->size, LV2_ATOM_BODY_CONST(atom));
+      const LV2_Atom* const atom  = &buffer.atom;
+      const uint32_t        frame = jalv_event_frame(jalv, ev.time, nframes);
+      lv2_evbuf_insert(port->evbuf,
+                       frame,
+                       0,
+                       atom->type,
+                       atom->size,
+                       LV2_ATOM_BODY_CONST(atom));
     } else {
       jalv_log(
         JALV_LOG_ERR, "Unknown control change protocol %u\n", ev.protocol);
     }
   }
+
+  jalv_ring_end_read(ring);
+}
+
+void
+jalv_apply_ui_events(Jalv* jalv, uint32_t nframes)
+{
+  jalv->cycle_last  = jalv->cycle_start;
+  jalv->cycle_start = jalv_clock_now();
+
+  // Apply single controls before batches.  Values are only written to the
+  // channel when every batch has been applied, and are otherwise queued after
+  // them in the ring (see jalv_write_control()), so this preserves the order
+  jalv_control_channel_read(jalv->ui_controls, jalv_apply_control, jalv);
+  jalv_apply_ring_events(jalv, jalv->ui_priority, nframes, UINT32_MAX);
+
+  // Apply bulk events up to about a buffer's worth
+  jalv_apply_ring_events(
+    jalv, jalv->ui_to_plugin, nframes, (uint32_t)jalv->midi_buf_size);
+}
+
+void
+jalv_ui_subscribe(Jalv* const    jalv,
+                  const uint32_t port_index,
+                  const LV2_URID type)
+{
+  struct Port* const port = &jalv->ports[port_index];
+  if (port->notify && (!port->notify[0] || !type)) {
+    port->notify[0] = 0U; // An empty list means all types
+    return;
+  }
+
+  size_t n = 0U;
+  while (port->notify && port->notify[n]) {
+    if (port->notify[n++] == type) {
+      return;
+    }
+  }
+
+  uint32_t* const notify =
+    (uint32_t*)realloc(port->notify, (n + 2U) * sizeof(uint32_t));
+  if (notify) {
+    notify[n]      = type;
+    notify[n + 1U] = 0U;
+    port->notify   = notify;
+  }
+}
+
+bool
+jalv_ui_is_subscribed(const Jalv* const jalv,
+                      const uint32_t    port_index,
+                      const LV2_URID    type)
+{
+  const uint32_t* const notify = jalv->ports[port_index].notify;
+  if (!notify) {
+    return false;
+  }
+
+  for (const uint32_t* t = notify; *t; ++t) {
+    if (*t == type) {
+      return true;
+    }
+  }
+
+  return !notify[0];
+}
+
+/// Subscribe the UI to all events from every output event port
+static void
+jalv_ui_subscribe_all(Jalv* const jalv)
+{
+  for (uint32_t i = 0U; i < jalv->num_ports; ++i) {
+    const struct Port* const port = &jalv->ports[i];
+    if (port->flow == FLOW_OUTPUT && port->type == TYPE_EVENT) {
+      jalv_ui_subscribe(jalv, i, 0U);
+    }
+  }
+}
+
+/// Subscribe the custom UI to its ui:portNotification, return false if none
+static bool
+jalv_ui_subscribe_notifications(Jalv* const jalv)
+{
+  LilvWorld* const      world  = jalv->world;
+  const LilvNode* const ui_uri = lilv_ui_get_uri(jalv->ui);
+  const LilvNode* const plugin = lilv_plugin_get_uri(jalv->plugin);
+
+  lilv_world_load_resource(world, ui_uri);
+
+  bool       found = false;
+  LilvNodes* notes =
+    lilv_world_find_nodes(world, ui_uri, jalv->nodes.ui_portNotification, NULL);
+  LILV_FOREACH (nodes, n, notes) {
+    const LilvNode* const note = lilv_nodes_get(notes, n);
+    LilvNode* const for_plugin =
+      lilv_world_get(world, note, jalv->nodes.ui_plugin, NULL);
+    LilvNode* const symbol =
+      lilv_world_get(world, note, jalv->nodes.lv2_symbol, NULL);
+    LilvNode* const index =
+      lilv_world_get(world, note, jalv->nodes.ui_portIndex, NULL);
+
+    struct Port* port = NULL;
+    if (for_plugin && !lilv_node_equals(for_plugin, plugin)) {
+      // Notification for another plugin that shares this UI
+    } else if (symbol) {
+      port = jalv_port_by_symbol(jalv, lilv_node_as_string(symbol));
+    } else if (index && lilv_node_is_int(index) &&
+               (uint32_t)lilv_node_as_int(index) < jalv->num_ports) {
+      port = &jalv->ports[lilv_node_as_int(index)];
+    }
+
+    if (port) {
+      // Subscribe to each notifyType, or to everything if there are none
+      LilvNodes* const types =
+        lilv_world_find_nodes(world, note, jalv->nodes.ui_notifyType, NULL);
+      if (!lilv_nodes_size(types)) {
+        jalv_ui_subscribe(jalv, port->index, 0U);
+      }
+
+      LILV_FOREACH (nodes, t, types) {
+        const char* const type = lilv_node_as_uri(lilv_nodes_get(types, t));
+        jalv_ui_subscribe(
+          jalv, port->index, jalv->map.map(jalv->map.handle, type));
+      }
+
+      lilv_nodes_free(types);
+      found = true;
+    }
+
+    lilv_node_free(index);
+    lilv_node_free(symbol);
+    lilv_node_free(for_plugin);
+  }
+
+  lilv_nodes_free(notes);
+  return found;
+}
+
+/// Subscribe the UI to the plugin events it needs
+static void
+jalv_init_subscriptions(Jalv* const jalv)
+{
+  if (jalv->opts.dump) {
+    jalv_ui_subscribe_all(jalv); // Send everything, so it's all dumped
+  } else if (jalv->ui) {
+    // Older UIs don't describe their notifications, so send them everything
+    if (!jalv_ui_subscribe_notifications(jalv)) {
+      jalv_ui_subscribe_all(jalv);
+    }
+  } else {
+    jalv_frontend_subscribe(jalv);
+  }
 }
 
 void
@@ -685,58 +1271,250 @@ jalv_init_ui(Jalv* jalv)
 
 static int
 jalv_write_control_change(Jalv* const       jalv,
-                          ZixRing* const    target,
+                          JalvRing* const   target,
                           const void* const header,
                           const uint32_t    header_size,
                           const void* const body,
                           const uint32_t    body_size)
 {
-  ZixRingTransaction tx = zix_ring_begin_write(target);
-  if (zix_ring_amend_write(target, &tx, header, header_size) ||
-      zix_ring_amend_write(target, &tx, body, body_size)) {
-    jalv_log(JALV_LOG_ERR,
-             target == jalv->plugin_to_ui ? "Plugin => UI buffer overflow"
-                                          : "UI => Plugin buffer overflow");
+  if (jalv_ring_write(target, header, header_size, body, body_size)) {
+    // Log only at powers of two, since overflows tend to come in floods
+    JalvRingStats stats;
+    jalv_ring_stats(target, &stats);
+    if (!(stats.n_dropped & (stats.n_dropped - 1U))) {
+      const char* const direction =
+        target == jalv->plugin_to_ui  ? "Plugin => UI"
+        : target == jalv->ui_priority ? "UI => Plugin priority"
+                                      : "UI => Plugin";
+
+      jalv_log(JALV_LOG_ERR,
+               "%s buffer overflow (%u dropped, %u bytes)\n",
+               direction,
+               stats.n_dropped,
+               stats.capacity);
+    }
     return -1;
   }
 
-  zix_ring_commit_write(target, &tx);
+  if (target == jalv->plugin_to_ui) {
+    JALV_ATOMIC_STORE(&jalv->ui_dirty, 1);
+  }
+
   return 0;
 }
 
+/// Return true if an event to the plugin is a small patch:Set
+static bool
+jalv_is_priority_event(const Jalv* const jalv,
+                       const uint32_t    size,
+                       const LV2_URID    type,
+                       const void* const body)
+{
+  return type == jalv->forge.Object && size <= MSG_BUFFER_SIZE &&
+         size >= sizeof(LV2_Atom_Object_Body) &&
+         ((const LV2_Atom_Object_Body*)body)->otype == jalv->urids.patch_Set;
+}
+
 int
 jalv_write_event(Jalv* const       jalv,
-                 ZixRing* const    target,
+                 JalvRing* const   target,
                  const uint32_t    port_index,
                  const uint32_t    size,
                  const LV2_URID    type,
                  const void* const body)
 {
-  // TODO: Be more discriminate about what to send
-
   typedef struct {
     ControlChange change;
     LV2_Atom      atom;
   } Header;
 
-  const Header header = {
-    {port_index, jalv->urids.atom_eventTransfer, sizeof(LV2_Atom) + size},
-    {size, type}};
+  const Header header = {{port_index,
+                          jalv->urids.atom_eventTransfer,
+                          sizeof(LV2_Atom) + size,
+                          target == jalv->plugin_to_ui ? 0U : jalv_clock_now()},
+                         {size, type}};
+
+  // Send property changes to the plugin ahead of any bulk events
+  JalvRing* const ring =
+    (target == jalv->ui_to_plugin &&
+     jalv_is_priority_event(jalv, size, type, body))
+      ? jalv->ui_priority
+      : target;
 
   return jalv_write_control_change(
-    jalv, target, &header, sizeof(header), body, size);
+    jalv, ring, &header, sizeof(header), body, size);
 }
 
 int
-jalv_write_control(Jalv* const    jalv,
-                   ZixRing* const target,
-                   const uint32_t port_index,
-                   const float    value)
+jalv_write_events(Jalv* const      jalv,
+                  const uint32_t   port_index,
+                  LV2_Evbuf* const evbuf)
 {
-  const ControlChange header = {port_index, 0, sizeof(value)};
+  const uint32_t* const notify = jalv->ports[port_index].notify;
+  const uint32_t        size   = lv2_evbuf_get_size(evbuf);
+  if (!notify || !size) {
+    return 0;
+  }
+
+  // Send the whole sequence as is if the UI is subscribed to everything
+  const LV2_Atom_Sequence* const seq =
+    (const LV2_Atom_Sequence*)lv2_evbuf_get_buffer(evbuf);
+  const void* body      = LV2_ATOM_CONTENTS_CONST(LV2_Atom_Sequence, seq);
+  uint32_t    body_size = size;
+  if (notify[0]) {
+    // Otherwise, copy only the subscribed events, which are already padded
+    uint8_t* const buf = (uint8_t*)jalv->ui_seq_buf;
+
+    body_size = 0U;
+    LV2_ATOM_SEQUENCE_FOREACH (seq, ev) {
+      if (jalv_ui_is_subscribed(jalv, port_index, ev->body.type)) {
+        const uint32_t ev_size =
+          lv2_atom_pad_size(sizeof(LV2_Atom_Event) + ev->body.size);
+
+        memcpy(buf + body_size, ev, ev_size);
+        body_size += ev_size;
+      }
+    }
+
+    if (!body_size) {
+      return 0;
+    }
+
+    body = buf;
+  }
+
+  const ControlChange header = {
+    port_index, jalv->urids.jalv_EventSequence, body_size, 0U};
 
   return jalv_write_control_change(
-    jalv, target, &header, sizeof(header), &value, sizeof(value));
+    jalv, jalv->plugin_to_ui, &header, sizeof(header), body, body_size);
+}
+
+/// Send a batch of control values to the plugin through the priority ring
+static int
+jalv_write_batch(Jalv* const               jalv,
+                 const ControlValue* const values,
+                 const uint32_t            n_values)
+{
+  const uint32_t      size   = n_values * sizeof(ControlValue);
+  const ControlChange header = {
+    0U, jalv->urids.jalv_ControlBatch, size, jalv_clock_now()};
+
+  if (jalv_write_control_change(
+        jalv, jalv->ui_priority, &header, sizeof(header), values, size)) {
+    return -1;
+  }
+
+  ++jalv->batches_sent;
+  return 0;
+}
+
+int
+jalv_write_control(Jalv* const     jalv,
+                   JalvRing* const target,
+                   const uint32_t  port_index,
+                   const float     value)
+{
+  if (target == jalv->ui_to_plugin &&
+      jalv->batches_sent != JALV_ATOMIC_LOAD(&jalv->batches_done)) {
+    // Queue behind batches that haven't been applied yet, to keep the order
+    const ControlValue control = {port_index, value};
+    return jalv_write_batch(jalv, &control, 1U);
+  }
+
+  // Control values are coalesced, so rings are only used for atoms
+  JalvControlChannel* const channel =
+    target == jalv->plugin_to_ui ? jalv->plugin_controls : jalv->ui_controls;
+
+  jalv_control_channel_write(channel, port_index, value);
+  if (target == jalv->plugin_to_ui) {
+    JALV_ATOMIC_STORE(&jalv->ui_dirty, 1);
+  }
+
+  return 0;
+}
+
+int
+jalv_batch_begin(Jalv* const jalv)
+{
+  if (jalv->batch) {
+    return 1;
+  }
+
+  jalv->batch   = (ControlValue*)calloc(MAX_BATCH_SIZE, sizeof(ControlValue));
+  jalv->n_batch = 0U;
+  return !jalv->batch;
+}
+
+int
+jalv_batch_set(Jalv* const jalv, const uint32_t port_index, const float value)
+{
+  if (!jalv->batch || port_index >= jalv->num_ports) {
+    return 1;
+  }
+
+  // Replace any earlier value for this port, so only the last one is applied
+  for (uint32_t i = 0U; i < jalv->n_batch; ++i) {
+    if (jalv->batch[i].index == port_index) {
+      jalv->batch[i].value = value;
+      return 0;
+    }
+  }
+
+  if (jalv->n_batch == MAX_BATCH_SIZE) {
+    return 1;
+  }
+
+  jalv->batch[jalv->n_batch].index = port_index;
+  jalv->batch[jalv->n_batch].value = value;
+  ++jalv->n_batch;
+  return 0;
+}
+
+int
+jalv_batch_commit(Jalv* const jalv)
+{
+  if (!jalv->batch) {
+    return 1;
+  }
+
+  // Send the whole batch as one message, which is read in a single cycle
+  const int st = jalv->n_batch
+                   ? jalv_write_batch(jalv, jalv->batch, jalv->n_batch)
+                   : 0;
+
+  jalv_batch_abort(jalv);
+  return st;
+}
+
+void
+jalv_batch_abort(Jalv* const jalv)
+{
+  free(jalv->batch);
+  jalv->batch   = NULL;
+  jalv->n_batch = 0U;
+}
+
+void
+jalv_send_control_output(Jalv* const jalv, const uint32_t port_index)
+{
+  struct Port* const port = &jalv->ports[port_index];
+  if (port->due) {
+    return; // Not due for an update yet
+  }
+
+  const float value = isnan(port->peak) ? port->control : port->peak;
+
+  port->due  = port->period;
+  port->peak = NAN;
+  if (fabsf(value - port->sent) <= port->epsilon) {
+    JALV_ATOMIC_ADD(&jalv->n_updates_kept, 1);
+    return;
+  }
+
+  port->sent = value;
+  jalv_write_control(jalv, jalv->plugin_to_ui, port_index, value);
+  JALV_ATOMIC_ADD(&jalv->n_updates_sent, 1);
 }
 
 void
@@ -763,14 +1541,99 @@ jalv_dump_atom(Jalv* const           jalv,
   }
 }
 
+/// Reduce the output controls of a cycle into the value for the next update
+static void
+jalv_aggregate_outputs(Jalv* const jalv)
+{
+  for (uint32_t i = 0U; i < jalv->num_ports; ++i) {
+    struct Port* const port = &jalv->ports[i];
+    if (port->aggregate == AGGREGATE_MAX) {
+      port->peak = port->control > port->peak ? port->control : port->peak;
+    } else if (port->aggregate == AGGREGATE_MIN) {
+      port->peak = port->control < port->peak ? port->control : port->peak;
+    } else {
+      continue;
+    }
+
+    if (isnan(port->peak)) {
+      port->peak = port->control;
+    }
+  }
+}
+
+/// Count down to the next UI update of each output, and return true if any
+static bool
+jalv_schedule_outputs(Jalv* const jalv, const uint32_t nframes)
+{
+  bool due = false;
+  for (uint32_t i = 0U; i < jalv->num_ports; ++i) {
+    struct Port* const port = &jalv->ports[i];
+    if (port->period) {
+      port->due = port->due > nframes ? port->due - nframes : 0U;
+      due       = due || !port->due;
+    }
+  }
+
+  return due;
+}
+
+/// Wake the UI if the plugin sent it anything, at most at the update rate
+static void
+jalv_schedule_wakeup(Jalv* const jalv, const uint32_t nframes)
+{
+  jalv->wakeup_due = jalv->wakeup_due > nframes ? jalv->wakeup_due - nframes
+                                                : 0U;
+
+  if (!jalv->wakeup_due && JALV_ATOMIC_EXCHANGE(&jalv->ui_dirty, 0)) {
+    jalv_wakeup_signal(jalv->wakeup);
+    jalv->wakeup_due = (uint32_t)(jalv->sample_rate / jalv->ui_update_hz);
+  }
+}
+
 bool
 jalv_run(Jalv* jalv, uint32_t nframes)
 {
-  // Read and apply control change events from UI
+  // Wake the UI for anything sent during previous cycles
+  if (jalv->has_ui && jalv->wakeup) {
+    jalv_schedule_wakeup(jalv, nframes);
+  }
+
+  // Read and apply control change events from UI, then modulation
   jalv_apply_ui_events(jalv, nframes);
+  if (jalv->modulators) {
+    jalv_modulators_run(jalv->modulators, nframes);
+  }
 
-  // Run plugin for this cycle
-  lilv_instance_run(jalv->instance, nframes);
+  // Run plugin for this cycle, unless the watchdog has stopped it, or it is
+  // bypassed and may be left idle
+  const uint64_t t0 = jalv->watchdog ? jalv_clock_now() : 0U;
+  const bool     run =
+    (!jalv->watchdog || jalv_watchdog_ready(jalv->watchdog, t0)) &&
+    (!jalv->opts.bypass_idle || !jalv->stage ||
+     !jalv_stage_bypassed(jalv->stage));
+  if (run) {
+    lilv_instance_run(jalv->instance, nframes);
+    if (jalv->watchdog) {
+      const double period = nframes * 1.0e9 / jalv->sample_rate;
+      if (jalv_watchdog_record(
+            jalv->watchdog, t0, jalv_clock_now(), (uint64_t)period)) {
+        zix_sem_post(&jalv->watchdog_sem); // Wake reporter thread
+      }
+    }
+  }
+
+  if (jalv->stage) {
+    jalv_stage_run(jalv->stage, nframes, jalv->plugin_latency, run);
+  }
+  if (jalv->meters) {
+    jalv_meters_run(jalv->meters, nframes);
+  }
+  if (jalv->scope) {
+    jalv_scope_run(jalv->scope, nframes);
+  }
+  if (jalv->has_ui) {
+    jalv_aggregate_outputs(jalv);
+  }
 
   // Process any worker replies and end the cycle
   LV2_Handle handle = lilv_instance_get_handle(jalv->instance);
@@ -778,16 +1641,51 @@ jalv_run(Jalv* jalv, uint32_t nframes)
   jalv_worker_emit_responses(jalv->worker, handle);
   jalv_worker_end_run(jalv->worker);
 
-  // Check if it's time to send updates to the UI
-  jalv->event_delta_t += nframes;
-  bool     send_ui_updates = false;
-  uint32_t update_frames   = (uint32_t)(jalv->sample_rate / jalv->ui_update_hz);
-  if (jalv->has_ui && (jalv->event_delta_t > update_frames)) {
-    send_ui_updates     = true;
-    jalv->event_delta_t = 0;
+  // Check if it's time to send any updates to the UI
+  return jalv->has_ui && jalv_schedule_outputs(jalv, nframes);
+}
+
+/// Send the value of a control port to the UI
+static void
+jalv_emit_control(void* const handle, const uint32_t index, const float value)
+{
+  Jalv* const jalv = (Jalv*)handle;
+
+  jalv_ui_port_event(jalv, index, sizeof(float), 0, &value);
+  if (jalv->opts.print_controls) {
+    jalv_print_control(jalv, &jalv->ports[index], value);
   }
+}
 
-  return send_ui_updates;
+/// Emit each event of a plugin output sequence to the UI and return the count
+static uint32_t
+jalv_emit_events(Jalv* const       jalv,
+                 const uint32_t    port_index,
+                 const void* const data,
+                 const uint32_t    size)
+{
+  const uint8_t* const events   = (const uint8_t*)data;
+  uint32_t             n_events = 0U;
+  uint32_t             offset   = 0U;
+  while (offset + sizeof(LV2_Atom_Event) <= size) {
+    const LV2_Atom_Event* const ev = (const LV2_Atom_Event*)(events + offset);
+    if (ev->body.size > size - offset - sizeof(LV2_Atom_Event)) {
+      jalv_log(JALV_LOG_ERR, "Corrupt event sequence in plugin to UI ring\n");
+      break;
+    }
+
+    jalv_dump_atom(jalv, stdout, "Plugin => UI", &ev->body, 35);
+    jalv_ui_port_event(jalv,
+                       port_index,
+                       sizeof(LV2_Atom) + ev->body.size,
+                       jalv->urids.atom_eventTransfer,
+                       &ev->body);
+
+    offset += lv2_atom_pad_size(sizeof(LV2_Atom_Event) + ev->body.size);
+    ++n_events;
+  }
+
+  return n_events;
 }
 
 int
@@ -799,34 +1697,123 @@ jalv_update(Jalv* jalv)
     return 0;
   }
 
-  // Emit UI events
-  ControlChange ev;
-  const size_t  space = zix_ring_read_space(jalv->plugin_to_ui);
-  for (size_t i = 0; i + sizeof(ev) < space; i += sizeof(ev) + ev.size) {
-    // Read event header to get the size
-    zix_ring_read(jalv->plugin_to_ui, &ev, sizeof(ev));
+  // Emit the latest value of each changed control
+  jalv_control_channel_read(jalv->plugin_controls, jalv_emit_control, jalv);
+
+  // Grow the event buffer if the ring has been resized
+  ZixRing* const ring     = jalv_ring_begin_read(jalv->plugin_to_ui);
+  const uint32_t capacity = zix_ring_capacity(ring);
+  if (capacity > jalv->ui_event_cap) {
+    void* const ui_event_buf = realloc(jalv->ui_event_buf, capacity);
+    if (!ui_event_buf) {
+      jalv_ring_end_read(jalv->plugin_to_ui);
+      return 1;
+    }
 
-    // Resize read buffer if necessary
-    jalv->ui_event_buf = realloc(jalv->ui_event_buf, ev.size);
-    void* const buf    = jalv->ui_event_buf;
+    jalv->ui_event_buf = ui_event_buf;
+    jalv->ui_event_cap = capacity;
+  }
 
-    // Read event body
-    zix_ring_read(jalv->plugin_to_ui, buf, ev.size);
+  // Read all events at once, which are always complete since they are
+  // written to the ring in a single transaction
+  uint8_t* const buf  = (uint8_t*)jalv->ui_event_buf;
+  const uint32_t size = zix_ring_read(ring, buf, zix_ring_read_space(ring));
+  jalv_ring_end_read(jalv->plugin_to_ui);
+
+  // Emit UI events in place
+  uint32_t n_events = 0U;
+  uint32_t offset   = 0U;
+  while (offset + sizeof(ControlChange) <= size) {
+    ControlChange ev;
+    memcpy(&ev, buf + offset, sizeof(ev));
+
+    const uint32_t body = offset + (uint32_t)sizeof(ev);
+    if (ev.size > size - body) {
+      jalv_log(JALV_LOG_ERR, "Corrupt event in plugin to UI ring\n");
+      break;
+    }
+
+    // Move the body back over the header so that the atom is aligned
+    void* const data = buf + (body & ~7U);
+    memmove(data, buf + body, ev.size);
+    offset = body + ev.size;
+
+    if (ev.protocol == jalv->urids.jalv_EventSequence) {
+      n_events += jalv_emit_events(jalv, ev.index, data, ev.size);
+      continue;
+    }
 
     if (ev.protocol == jalv->urids.atom_eventTransfer) {
-      jalv_dump_atom(jalv, stdout, "Plugin => UI", (const LV2_Atom*)buf, 35);
+      jalv_dump_atom(jalv, stdout, "Plugin => UI", (const LV2_Atom*)data, 35);
     }
 
-    jalv_ui_port_event(jalv, ev.index, ev.size, ev.protocol, buf);
+    jalv_ui_port_event(jalv, ev.index, ev.size, ev.protocol, data);
+    ++n_events;
+  }
 
-    if (ev.protocol == 0 && jalv->opts.print_controls) {
-      jalv_print_control(jalv, &jalv->ports[ev.index], *(float*)buf);
-    }
+  if (size) {
+    jalv->drain_last  = n_events;
+    jalv->drain_max   = MAX(jalv->drain_max, n_events);
+    jalv->drain_bytes = MAX(jalv->drain_bytes, size);
   }
 
   return 1;
 }
 
+/// Set how output controls are reduced from arguments like "SYMBOL=max"
+static void
+jalv_apply_aggregate_args(Jalv* const jalv)
+{
+  static const char* const names[] = {"last", "max", "min"};
+
+  for (char** a = jalv->opts.aggregates; a && *a; ++a) {
+    char sym[256];
+    char mode[8];
+    if (sscanf(*a, "%255[^=]=%7s", sym, mode) != 2) {
+      jalv_log(JALV_LOG_WARNING, "Ignoring invalid reduction `%s'\n", *a);
+      continue;
+    }
+
+    struct Port* const port = jalv_port_by_symbol(jalv, sym);
+    if (!port || port->flow != FLOW_OUTPUT || port->type != TYPE_CONTROL) {
+      jalv_log(JALV_LOG_WARNING, "Ignoring reduction of `%s'\n", sym);
+      continue;
+    }
+
+    size_t m = 0U;
+    while (m < ARRAY_SIZE(names) && strcmp(mode, names[m])) {
+      ++m;
+    }
+
+    if (m == ARRAY_SIZE(names)) {
+      jalv_log(JALV_LOG_WARNING, "Ignoring unknown reduction `%s'\n", mode);
+    } else {
+      port->aggregate = (int)m;
+    }
+  }
+}
+
+/// Set the UI update rates of outputs from arguments like "SYMBOL=30"
+static void
+jalv_apply_rate_args(Jalv* const jalv)
+{
+  for (char** r = jalv->opts.port_rates; r && *r; ++r) {
+    char  sym[256];
+    float rate = 0.0f;
+    if (sscanf(*r, "%255[^=]=%f", sym, &rate) != 2 || !(rate > 0.0f)) {
+      jalv_log(JALV_LOG_WARNING, "Ignoring invalid update rate `%s'\n", *r);
+      continue;
+    }
+
+    struct Port* const port = jalv_port_by_symbol(jalv, sym);
+    if (!port || port->flow != FLOW_OUTPUT || port->type != TYPE_CONTROL) {
+      jalv_log(JALV_LOG_WARNING, "Ignoring update rate of `%s'\n", sym);
+    } else {
+      port->rate = rate;
+    }
+  }
+}
+
 static bool
 jalv_apply_control_arg(Jalv* jalv, const char* s)
 {
@@ -854,6 +1841,9 @@ static void
 signal_handler(int ZIX_UNUSED(sig))
 {
   zix_sem_post(exit_sem);
+  if (exit_wakeup) {
+    jalv_wakeup_signal(exit_wakeup);
+  }
 }
 
 static void
@@ -866,7 +1856,8 @@ init_feature(LV2_Feature* const dest, const char* const URI, void* data)
 static void
 setup_signals(Jalv* const jalv)
 {
-  exit_sem = &jalv->done;
+  exit_sem    = &jalv->done;
+  exit_wakeup = jalv->wakeup;
 
 #if !defined(_WIN32) && USE_SIGACTION
   struct sigaction action;
@@ -955,6 +1946,8 @@ jalv_init_urids(Symap* const symap, JalvURIDs* const urids)
   urids->bufsz_maxBlockLength = MAP_URI(LV2_BUF_SIZE__maxBlockLength);
   urids->bufsz_minBlockLength = MAP_URI(LV2_BUF_SIZE__minBlockLength);
   urids->bufsz_sequenceSize   = MAP_URI(LV2_BUF_SIZE__sequenceSize);
+  urids->jalv_ControlBatch    = MAP_URI(JALV__ControlBatch);
+  urids->jalv_EventSequence   = MAP_URI(JALV__EventSequence);
   urids->log_Error            = MAP_URI(LV2_LOG__Error);
   urids->log_Trace            = MAP_URI(LV2_LOG__Trace);
   urids->log_Warning          = MAP_URI(LV2_LOG__Warning);
@@ -998,6 +1991,7 @@ jalv_init_nodes(LilvWorld* const world, JalvNodes* const nodes)
   nodes->lv2_connectionOptional = MAP_NODE(LV2_CORE__connectionOptional);
   nodes->lv2_control            = MAP_NODE(LV2_CORE__control);
   nodes->lv2_default            = MAP_NODE(LV2_CORE__default);
+  nodes->lv2_enabled            = MAP_NODE(LV2_CORE__enabled);
   nodes->lv2_enumeration        = MAP_NODE(LV2_CORE__enumeration);
   nodes->lv2_extensionData      = MAP_NODE(LV2_CORE__extensionData);
   nodes->lv2_integer            = MAP_NODE(LV2_CORE__integer);
@@ -1019,6 +2013,10 @@ jalv_init_nodes(LilvWorld* const world, JalvNodes* const nodes)
   nodes->rdfs_label             = MAP_NODE(LILV_NS_RDFS "label");
   nodes->rdfs_range             = MAP_NODE(LILV_NS_RDFS "range");
   nodes->rsz_minimumSize        = MAP_NODE(LV2_RESIZE_PORT__minimumSize);
+  nodes->ui_notifyType          = MAP_NODE(LV2_UI__notifyType);
+  nodes->ui_plugin              = MAP_NODE(LV2_UI__plugin);
+  nodes->ui_portIndex           = MAP_NODE(LV2_UI__portIndex);
+  nodes->ui_portNotification    = MAP_NODE(LV2_UI__portNotification);
   nodes->ui_showInterface       = MAP_NODE(LV2_UI__showInterface);
   nodes->work_interface         = MAP_NODE(LV2_WORKER__interface);
   nodes->work_schedule          = MAP_NODE(LV2_WORKER__schedule);
@@ -1138,6 +2136,47 @@ jalv_init_options(Jalv* const jalv)
                (void*)jalv->features.options);
 }
 
+/**
+   Set the period of UI updates for each output control.
+
+   The UI update rate is then raised to the fastest rate of any output, so the
+   UI never wakes more often than the most frequently updated port needs.
+*/
+static void
+jalv_init_update_periods(Jalv* const jalv)
+{
+  const float default_hz  = jalv->ui_update_hz;
+  bool        any_default = false;
+  float       max_hz      = 0.0f;
+  for (uint32_t i = 0U; i < jalv->num_ports; ++i) {
+    struct Port* const port = &jalv->ports[i];
+    if (port->flow != FLOW_OUTPUT) {
+      continue;
+    }
+
+    if (port->type != TYPE_CONTROL) {
+      any_default = true; // Events are forwarded at the default rate
+      continue;
+    }
+
+    float hz = port->rate;
+    if (!hz) {
+      const bool latency = lilv_port_has_property(
+        jalv->plugin, port->lilv_port, jalv->nodes.lv2_reportsLatency);
+
+      hz          = latency ? MIN(LATENCY_UPDATE_HZ, default_hz) : default_hz;
+      any_default = any_default || !latency;
+    }
+
+    hz           = MIN(60.0f, hz);
+    max_hz       = MAX(max_hz, hz);
+    port->period = (uint32_t)(jalv->sample_rate / hz);
+  }
+
+  jalv->ui_update_hz = (any_default || !max_hz) ? MAX(default_hz, max_hz)
+                                                 : max_hz;
+}
+
 static void
 jalv_init_display(Jalv* const jalv)
 {
@@ -1161,6 +2200,7 @@ jalv_init_display(Jalv* const jalv)
   // The UI can only go so fast, clamp to reasonable limits
   jalv->ui_update_hz     = MIN(60, jalv->ui_update_hz);
   jalv->opts.buffer_size = MAX(4096, jalv->opts.buffer_size);
+  jalv_init_update_periods(jalv);
   jalv_log(JALV_LOG_INFO, "Comm buffers: %u bytes\n", jalv->opts.buffer_size);
   jalv_log(JALV_LOG_INFO, "Update rate:  %.01f Hz\n", jalv->ui_update_hz);
   jalv_log(JALV_LOG_INFO, "Scale factor: %.01f\n", jalv->ui_scale_factor);
@@ -1225,10 +2265,12 @@ jalv_open(Jalv* const jalv, int* argc, char*** argv)
   // Get plugin URI from loaded state or command line
   LilvState* state      = NULL;
   LilvNode*  plugin_uri = NULL;
+  bool       load_dir   = false;
   if (jalv->opts.load) {
     struct stat info;
-    stat(jalv->opts.load, &info);
-    if ((info.st_mode & S_IFMT) == S_IFDIR) {
+    load_dir = !stat(jalv->opts.load, &info) &&
+               (info.st_mode & S_IFMT) == S_IFDIR;
+    if (load_dir) {
       char* path = jalv_strjoin(jalv->opts.load, "/state.ttl");
       state = lilv_state_new_from_file(jalv->world, &jalv->map, NULL, path);
       free(path);
@@ -1336,6 +2378,8 @@ jalv_open(Jalv* const jalv, int* argc, char*** argv)
 
   // Create port and control structures
   jalv_create_ports(jalv);
+  jalv_apply_aggregate_args(jalv);
+  jalv_apply_rate_args(jalv);
   jalv_create_controls(jalv, true);
   jalv_create_controls(jalv, false);
 
@@ -1358,14 +2402,47 @@ jalv_open(Jalv* const jalv, int* argc, char*** argv)
     jalv->opts.buffer_size = jalv->midi_buf_size * N_BUFFER_CYCLES;
   }
 
+  if (jalv_create_stage(jalv)) {
+    jalv_log(JALV_LOG_ERR, "Failed to create output stage\n");
+    jalv_close(jalv);
+    return -6;
+  }
+
+  if (!(jalv->modulators =
+          jalv_modulators_new(jalv->num_ports, jalv->sample_rate))) {
+    jalv_log(JALV_LOG_ERR, "Failed to create modulators\n");
+    jalv_close(jalv);
+    return -6;
+  }
+
+  if (jalv->opts.meter_rate > 0.0 && jalv_create_meters(jalv)) {
+    jalv_log(JALV_LOG_ERR, "Failed to create meters\n");
+    jalv_close(jalv);
+    return -6;
+  }
+
+  if (jalv->opts.scope_taps && jalv_create_scope(jalv)) {
+    jalv_log(JALV_LOG_ERR, "Failed to create scope taps\n");
+    jalv_close(jalv);
+    return -6;
+  }
+
+  if (jalv->opts.watchdog && jalv_create_watchdog(jalv)) {
+    jalv_log(JALV_LOG_ERR, "Failed to create watchdog\n");
+    jalv_close(jalv);
+    return -6;
+  }
+
   jalv_init_display(jalv);
   jalv_init_options(jalv);
 
   // Create Plugin <=> UI communication buffers
-  jalv->ui_to_plugin = zix_ring_new(NULL, jalv->opts.buffer_size);
-  jalv->plugin_to_ui = zix_ring_new(NULL, jalv->opts.buffer_size);
-  zix_ring_mlock(jalv->ui_to_plugin);
-  zix_ring_mlock(jalv->plugin_to_ui);
+  jalv->ui_priority     = jalv_ring_new(PRIORITY_RING_SIZE);
+  jalv->ui_to_plugin    = jalv_ring_new(jalv->opts.buffer_size);
+  jalv->plugin_to_ui    = jalv_ring_new(jalv->opts.buffer_size);
+  jalv->ui_controls     = jalv_control_channel_new(jalv->num_ports);
+  jalv->plugin_controls = jalv_control_channel_new(jalv->num_ports);
+  jalv->wakeup          = jalv_wakeup_new();
 
   // Build feature list for passing to plugins
   const LV2_Feature* const features[] = {&jalv->features.map_feature,
@@ -1444,6 +2521,18 @@ jalv_open(Jalv* const jalv, int* argc, char*** argv)
     jalv_backend_activate_port(jalv, i);
   }
 
+  // Map control inputs directly to their controls, once they are registered
+  for (char** c = jalv->opts.control_inputs; c && *c; ++c) {
+    char cmd[1024];
+    snprintf(cmd, sizeof(cmd), "mod input %s\n", *c);
+    jalv_process_host_command(jalv, cmd);
+  }
+
+  // Restore any modulators saved along with state in a directory
+  if (load_dir) {
+    jalv_load_modulators(jalv, jalv->opts.load);
+  }
+
   // Check if plugin has a designated BPM port
   jalv->bpm_port_index = -1;
   const LilvPort *bpm_port = lilv_plugin_get_port_by_designation(jalv->plugin, jalv->nodes.lv2_InputPort, jalv->nodes.time_beatsPerMinute);
@@ -1465,6 +2554,9 @@ jalv_open(Jalv* const jalv, int* argc, char*** argv)
 
   // Discover UI
   jalv->has_ui = jalv_frontend_discover(jalv);
+  if (jalv->has_ui) {
+    jalv_init_subscriptions(jalv);
+  }
 
   // Activate audio backend
   jalv_backend_activate(jalv);
@@ -1490,6 +2582,7 @@ jalv_close(Jalv* const jalv)
     if (jalv->ports[i].evbuf) {
       lv2_evbuf_free(jalv->ports[i].evbuf);
     }
+    free(jalv->ports[i].notify);
   }
 
   // Destroy the worker
@@ -1507,8 +2600,13 @@ jalv_close(Jalv* const jalv)
 
   // Clean up
   free(jalv->ports);
-  zix_ring_free(jalv->ui_to_plugin);
-  zix_ring_free(jalv->plugin_to_ui);
+  jalv_ring_free(jalv->ui_priority);
+  jalv_ring_free(jalv->ui_to_plugin);
+  jalv_ring_free(jalv->plugin_to_ui);
+  exit_wakeup = NULL;
+  jalv_wakeup_free(jalv->wakeup);
+  jalv_control_channel_free(jalv->ui_controls);
+  jalv_control_channel_free(jalv->plugin_controls);
   for (LilvNode** n = (LilvNode**)&jalv->nodes; *n; ++n) {
     lilv_node_free(*n);
   }
@@ -1530,6 +2628,18 @@ jalv_close(Jalv* const jalv)
     free(control);
   }
   free(jalv->controls.controls);
+  jalv_stage_free(jalv->stage);
+  jalv_meters_free(jalv->meters);
+  jalv_modulators_free(jalv->modulators);
+  jalv_scope_free(jalv->scope);
+  if (jalv->watchdog) {
+    JALV_ATOMIC_STORE(&jalv->watchdog_exit, 1);
+    zix_sem_post(&jalv->watchdog_sem);
+    zix_thread_join(jalv->watchdog_thread);
+    zix_sem_destroy(&jalv->watchdog_sem);
+    jalv_watchdog_free(jalv->watchdog);
+  }
+  free(jalv->batch);
 
   sratom_free(jalv->sratom);
   sratom_free(jalv->ui_sratom);
@@ -1542,11 +2652,19 @@ jalv_close(Jalv* const jalv)
   remove(jalv->temp_dir);
   free(jalv->temp_dir);
   free(jalv->ui_event_buf);
+  free(jalv->ui_seq_buf);
   free(jalv->feature_list);
 
   free(jalv->opts.name);
   free(jalv->opts.load);
   free(jalv->opts.controls);
+  free(jalv->opts.hidden_ports);
+  free(jalv->opts.input_buses);
+  free(jalv->opts.scope_taps);
+  free(jalv->opts.watchdog);
+  free(jalv->opts.control_inputs);
+  free(jalv->opts.aggregates);
+  free(jalv->opts.port_rates);
 
   return 0;
 }
@@ -42,6 +42,15 @@
 #    endif
 #  endif
 
+// POSIX.1-2001: clock_gettime()
+#  ifndef HAVE_CLOCK_GETTIME
+#    if defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112L
+#      define HAVE_CLOCK_GETTIME 1
+#    else
+#      define HAVE_CLOCK_GETTIME 0
+#    endif
+#  endif
+
 // POSIX.1-2001: fileno()
 #  ifndef HAVE_FILENO
 #    if defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112L
@@ -69,6 +78,15 @@
 #    endif
 #  endif
 
+// POSIX.1-2001: pipe(), fcntl(), and poll()
+#  ifndef HAVE_PIPE
+#    if defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112L
+#      define HAVE_PIPE 1
+#    else
+#      define HAVE_PIPE 0
+#    endif
+#  endif
+
 // POSIX.1-2001: posix_memalign()
 #  ifndef HAVE_POSIX_MEMALIGN
 #    if defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112L
@@ -87,6 +105,15 @@
 #    endif
 #  endif
 
+// GNU: pthread_setaffinity_np()
+#  ifndef HAVE_PTHREAD_SETAFFINITY_NP
+#    if defined(__linux__) && defined(__GLIBC__)
+#      define HAVE_PTHREAD_SETAFFINITY_NP 1
+#    else
+#      define HAVE_PTHREAD_SETAFFINITY_NP 0
+#    endif
+#  endif
+
 // Suil
 #  ifndef HAVE_SUIL
 #    ifdef __has_include
@@ -130,6 +157,12 @@
   if the build system defines them all.
 */
 
+#if HAVE_CLOCK_GETTIME
+#  define USE_CLOCK_GETTIME 1
+#else
+#  define USE_CLOCK_GETTIME 0
+#endif
+
 #if HAVE_FILENO
 #  define USE_FILENO 1
 #else
@@ -152,6 +185,12 @@
 #  define USE_MLOCK 0
 #endif
 
+#if HAVE_PIPE
+#  define USE_PIPE 1
+#else
+#  define USE_PIPE 0
+#endif
+
 #if HAVE_POSIX_MEMALIGN
 #  define USE_POSIX_MEMALIGN 1
 #else
@@ -164,6 +203,12 @@
 #  define USE_SIGACTION 0
 #endif
 
+#if HAVE_PTHREAD_SETAFFINITY_NP
+#  define USE_PTHREAD_SETAFFINITY_NP 1
+#else
+#  define USE_PTHREAD_SETAFFINITY_NP 0
+#endif
+
 #if HAVE_SUIL
 #  define USE_SUIL 1
 #else
@@ -1,6 +1,7 @@
 // Copyright 2007-2022 David Robillard <d@drobilla.net>
 // SPDX-License-Identifier: ISC
 
+#include "command.h"
 #include "control.h"
 #include "frontend.h"
 #include "jalv_config.h"
@@ -10,6 +11,7 @@
 #include "port.h"
 #include "state.h"
 #include "types.h"
+#include "wakeup.h"
 
 #include "lilv/lilv.h"
 #include "lv2/ui/ui.h"
@@ -26,6 +28,10 @@
 #  include <unistd.h>
 #endif
 
+#if USE_PIPE
+#  include <poll.h>
+#endif
+
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -39,18 +45,36 @@ print_usage(const char* name, bool error)
   fprintf(os, "Usage: %s [OPTION...] PLUGIN_URI\n", name);
   fprintf(os,
           "Run an LV2 plugin as a Jack application.\n"
+          "  -A SYM=MODE  Show the max, min, or last value of output SYM\n"
+          "               between UI updates\n"
+          "  -B           Do not run plugin while it is bypassed\n"
           "  -b SIZE      Buffer size for plugin <=> UI communication\n"
+          "  -C SYM       Add a JACK audio input that modulates control SYM\n"
           "  -c SYM=VAL   Set control value (e.g. \"vol=1.4\")\n"
+          "  -D CPU       Run plugin one period behind in a DSP thread on CPU\n"
+          "               (-1 for any CPU)\n"
           "  -d           Dump plugin <=> UI communication\n"
+          "  -G           Use generic process callback (for benchmarking)\n"
           "  -h           Display this help and exit\n"
           "  -i           Ignore keyboard input, run non-interactively\n"
+          "  -K           Measure short-term loudness when metering\n"
           "  -l DIR       Load state from save directory\n"
+          "  -M SYM=N     Mix N JACK ports into audio input SYM\n"
           "  -n NAME      JACK client name\n"
+          "  -O           Do not register optional audio/MIDI ports with JACK\n"
+          "  -o FACTOR    Run plugin at FACTOR (2 or 4) times the JACK rate\n"
           "  -p           Print control output changes to stdout\n"
+          "  -R HZ        Meter audio levels at HZ (see \"levels\" command)\n"
           "  -s           Show plugin UI if possible\n"
+          "  -T SYM=N:D   Capture the last N (decimated by D) frames of SYM\n"
           "  -t           Print trace messages from plugin\n"
           "  -U URI       Load the UI with the given URI\n"
+          "  -u SYM=HZ    Send output SYM to the UI at HZ\n"
           "  -V           Display version information and exit\n"
+          "  -W F:N:S     Bypass plugin for S seconds if it takes over F of\n"
+          "               the period for N cycles (e.g. \"0.9:4:1\")\n"
+          "  -w           Add host dry/wet mix and output gain controls\n"
+          "  -X PATTERN   Do not register ports whose symbol matches PATTERN\n"
           "  -x           Exit if the requested JACK client name is taken.\n");
   return error ? 1 : 0;
 }
@@ -91,9 +115,16 @@ int
 jalv_frontend_init(int* argc, char*** argv, JalvOptions* opts)
 {
   int n_controls = 0;
+  int n_hidden   = 0;
+  int n_buses    = 0;
+  int n_taps     = 0;
+  int n_inputs   = 0;
+  int n_reduced  = 0;
+  int n_rates    = 0;
   int a          = 1;
 
   opts->preset_path = jalv_get_working_dir();
+  opts->dsp_cpu     = -1;
 
   for (; a < *argc && (*argv)[a][0] == '-'; ++a) {
     if ((*argv)[a][1] == 'h') {
@@ -135,10 +166,99 @@ jalv_frontend_init(int* argc, char*** argv, JalvOptions* opts)
         (char**)realloc(opts->controls, (++n_controls + 1) * sizeof(char*));
       opts->controls[n_controls - 1] = (*argv)[a];
       opts->controls[n_controls]     = NULL;
+    } else if ((*argv)[a][1] == 'C') {
+      if (++a == *argc) {
+        fprintf(stderr, "Missing argument for -C\n");
+        return 1;
+      }
+      opts->control_inputs = (char**)realloc(opts->control_inputs,
+                                             (++n_inputs + 1) * sizeof(char*));
+      opts->control_inputs[n_inputs - 1] = (*argv)[a];
+      opts->control_inputs[n_inputs]     = NULL;
+    } else if ((*argv)[a][1] == 'A') {
+      if (++a == *argc) {
+        fprintf(stderr, "Missing argument for -A\n");
+        return 1;
+      }
+      opts->aggregates =
+        (char**)realloc(opts->aggregates, (++n_reduced + 1) * sizeof(char*));
+      opts->aggregates[n_reduced - 1] = (*argv)[a];
+      opts->aggregates[n_reduced]     = NULL;
+    } else if ((*argv)[a][1] == 'u') {
+      if (++a == *argc) {
+        fprintf(stderr, "Missing argument for -u\n");
+        return 1;
+      }
+      opts->port_rates =
+        (char**)realloc(opts->port_rates, (++n_rates + 1) * sizeof(char*));
+      opts->port_rates[n_rates - 1] = (*argv)[a];
+      opts->port_rates[n_rates]     = NULL;
+    } else if ((*argv)[a][1] == 'X') {
+      if (++a == *argc) {
+        fprintf(stderr, "Missing argument for -X\n");
+        return 1;
+      }
+      opts->hidden_ports =
+        (char**)realloc(opts->hidden_ports, (++n_hidden + 1) * sizeof(char*));
+      opts->hidden_ports[n_hidden - 1] = (*argv)[a];
+      opts->hidden_ports[n_hidden]     = NULL;
+    } else if ((*argv)[a][1] == 'M') {
+      if (++a == *argc) {
+        fprintf(stderr, "Missing argument for -M\n");
+        return 1;
+      }
+      opts->input_buses =
+        (char**)realloc(opts->input_buses, (++n_buses + 1) * sizeof(char*));
+      opts->input_buses[n_buses - 1] = (*argv)[a];
+      opts->input_buses[n_buses]     = NULL;
+    } else if ((*argv)[a][1] == 'T') {
+      if (++a == *argc) {
+        fprintf(stderr, "Missing argument for -T\n");
+        return 1;
+      }
+      opts->scope_taps =
+        (char**)realloc(opts->scope_taps, (++n_taps + 1) * sizeof(char*));
+      opts->scope_taps[n_taps - 1] = (*argv)[a];
+      opts->scope_taps[n_taps]     = NULL;
+    } else if ((*argv)[a][1] == 'R') {
+      if (++a == *argc) {
+        fprintf(stderr, "Missing argument for -R\n");
+        return 1;
+      }
+      opts->meter_rate = atof((*argv)[a]);
+    } else if ((*argv)[a][1] == 'K') {
+      opts->loudness = true;
+    } else if ((*argv)[a][1] == 'B') {
+      opts->bypass_idle = true;
+    } else if ((*argv)[a][1] == 'W') {
+      if (++a == *argc) {
+        fprintf(stderr, "Missing argument for -W\n");
+        return 1;
+      }
+      opts->watchdog = jalv_strdup((*argv)[a]);
+    } else if ((*argv)[a][1] == 'w') {
+      opts->output_stage = true;
+    } else if ((*argv)[a][1] == 'O') {
+      opts->hide_optional = true;
+    } else if ((*argv)[a][1] == 'o') {
+      if (++a == *argc) {
+        fprintf(stderr, "Missing argument for -o\n");
+        return 1;
+      }
+      opts->oversample = atoi((*argv)[a]);
     } else if ((*argv)[a][1] == 'i') {
       opts->non_interactive = true;
+    } else if ((*argv)[a][1] == 'D') {
+      if (++a == *argc) {
+        fprintf(stderr, "Missing argument for -D\n");
+        return 1;
+      }
+      opts->pipelined = true;
+      opts->dsp_cpu   = atoi((*argv)[a]);
     } else if ((*argv)[a][1] == 'd') {
       opts->dump = true;
+    } else if ((*argv)[a][1] == 'G') {
+      opts->generic_process = true;
     } else if ((*argv)[a][1] == 't') {
       opts->trace = true;
     } else if ((*argv)[a][1] == 'n') {
@@ -172,11 +292,10 @@ jalv_print_controls(Jalv* jalv, bool writable, bool readable)
     ControlID* const control = jalv->controls.controls[i];
     if ((control->is_writable && writable) ||
         (control->is_readable && readable)) {
-      struct Port* const port = &jalv->ports[control->index];
       jalv_log(JALV_LOG_INFO,
                "%s = %f\n",
                lilv_node_as_string(control->symbol),
-               port->control);
+               jalv_control_value(jalv, control));
     }
   }
 
@@ -199,6 +318,10 @@ jalv_process_command(Jalv* jalv, const char* cmd)
   char     sym[1024];
   uint32_t index = 0;
   float    value = 0.0f;
+  if (jalv_process_host_command(jalv, cmd)) {
+    return;
+  }
+
   if (!strncmp(cmd, "help", 4)) {
     fprintf(stderr,
             "Commands:\n"
@@ -212,6 +335,7 @@ jalv_process_command(Jalv* jalv, const char* cmd)
             "  set INDEX VALUE   Set control value by port index\n"
             "  set SYMBOL VALUE  Set control value by symbol\n"
             "  SYMBOL = VALUE    Set control value by symbol\n");
+    jalv_print_host_commands(stderr);
   } else if (strcmp(cmd, "presets\n") == 0) {
     jalv_unload_presets(jalv);
     jalv_load_presets(jalv, jalv_print_preset, NULL);
@@ -229,7 +353,7 @@ jalv_process_command(Jalv* jalv, const char* cmd)
     jalv_print_controls(jalv, false, true);
   } else if (sscanf(cmd, "set %u %f", &index, &value) == 2) {
     if (index < jalv->num_ports) {
-      jalv->ports[index].control = value;
+      jalv_write_control(jalv, jalv->ui_to_plugin, index, value);
       jalv_print_control(jalv, &jalv->ports[index], value);
     } else {
       fprintf(stderr, "error: port index out of range\n");
@@ -246,7 +370,7 @@ jalv_process_command(Jalv* jalv, const char* cmd)
       }
     }
     if (port) {
-      port->control = value;
+      jalv_write_control(jalv, jalv->ui_to_plugin, port->index, value);
       jalv_print_control(jalv, port, value);
     } else {
       fprintf(stderr, "error: no control named `%s'\n", sym);
@@ -262,6 +386,33 @@ jalv_frontend_discover(Jalv* jalv)
   return jalv->opts.show_ui;
 }
 
+#if USE_SUIL
+/// Wait for an idle period, and return true if the UI should be updated
+static bool
+jalv_wait_for_update(Jalv* const jalv)
+{
+#  if USE_PIPE
+  if (jalv->wakeup) {
+    // Return early if woken, since idle UIs only need to be called regularly
+    struct pollfd pfd = {jalv_wakeup_fd(jalv->wakeup), POLLIN, 0};
+    if (poll(&pfd, 1, 33) > 0) {
+      jalv_wakeup_clear(jalv->wakeup);
+      return true;
+    }
+
+    return false;
+  }
+#  endif
+
+#  ifdef _WIN32
+  Sleep(33);
+#  else
+  usleep(33333);
+#  endif
+  return true;
+}
+#endif
+
 static bool
 jalv_run_custom_ui(Jalv* jalv)
 {
@@ -279,18 +430,18 @@ jalv_run_custom_ui(Jalv* jalv)
   if (show_iface && idle_iface) {
     show_iface->show(suil_instance_get_handle(jalv->ui_instance));
 
-    // Drive idle interface until interrupted
+    // Drive idle interface until interrupted, and update when woken
+    bool update = true;
     while (zix_sem_try_wait(&jalv->done)) {
-      jalv_update(jalv);
+      if (update) {
+        jalv_update(jalv);
+      }
+
       if (idle_iface->idle(suil_instance_get_handle(jalv->ui_instance))) {
         break;
       }
 
-#  ifdef _WIN32
-      Sleep(33);
-#  else
-      usleep(33333);
-#  endif
+      update = jalv_wait_for_update(jalv);
     }
 
     show_iface->hide(suil_instance_get_handle(jalv->ui_instance));
@@ -315,6 +466,12 @@ jalv_frontend_scale_factor(Jalv* ZIX_UNUSED(jalv))
   return 1.0f;
 }
 
+void
+jalv_frontend_subscribe(Jalv* ZIX_UNUSED(jalv))
+{
+  // No generic UI, only custom UIs receive events
+}
+
 LilvNode*
 jalv_frontend_select_plugin(Jalv* jalv)
 {
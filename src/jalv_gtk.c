@@ -1,6 +1,7 @@
 // Copyright 2007-2022 David Robillard <d@drobilla.net>
 // SPDX-License-Identifier: ISC
 
+#include "command.h"
 #include "control.h"
 #include "frontend.h"
 #include "jalv_internal.h"
@@ -11,6 +12,7 @@
 #include "state.h"
 #include "types.h"
 #include "urids.h"
+#include "wakeup.h"
 
 #include "lilv/lilv.h"
 #include "lv2/atom/atom.h"
@@ -29,6 +31,10 @@
 #include <gobject/gclosure.h>
 #include <gtk/gtk.h>
 
+#if USE_PIPE
+#  include <glib-unix.h>
+#endif
+
 #include <float.h>
 #include <math.h>
 #include <stdbool.h>
@@ -77,8 +83,72 @@ int
 jalv_frontend_init(int* argc, char*** argv, JalvOptions* opts)
 {
   opts->preset_path = jalv_get_working_dir();
+  opts->dsp_cpu     = -1;
 
   const GOptionEntry entries[] = {
+    {"aggregate",
+     'A',
+     0,
+     G_OPTION_ARG_STRING_ARRAY,
+     &opts->aggregates,
+     "Show the max, min, or last value of output SYM between updates",
+     "SYM=MODE"},
+    {"bypass-idle",
+     'B',
+     0,
+     G_OPTION_ARG_NONE,
+     &opts->bypass_idle,
+     "Do not run plugin while it is bypassed",
+     NULL},
+    {"control-input",
+     'C',
+     0,
+     G_OPTION_ARG_STRING_ARRAY,
+     &opts->control_inputs,
+     "Add a Jack audio input that modulates control SYM",
+     "SYM"},
+    {"dsp-cpu",
+     'D',
+     0,
+     G_OPTION_ARG_INT,
+     &opts->dsp_cpu,
+     "Pin the pipelined DSP thread to CPU (implies --pipeline)",
+     "CPU"},
+    {"generic-process",
+     'G',
+     0,
+     G_OPTION_ARG_NONE,
+     &opts->generic_process,
+     "Use generic process callback (for benchmarking)",
+     NULL},
+    {"loudness",
+     'K',
+     0,
+     G_OPTION_ARG_NONE,
+     &opts->loudness,
+     "Measure short-term loudness when metering",
+     NULL},
+    {"pipeline",
+     'L',
+     0,
+     G_OPTION_ARG_NONE,
+     &opts->pipelined,
+     "Run plugin one period behind in a separate DSP thread",
+     NULL},
+    {"mix-input",
+     'M',
+     0,
+     G_OPTION_ARG_STRING_ARRAY,
+     &opts->input_buses,
+     "Mix N JACK ports into audio input SYM",
+     "SYM=N"},
+    {"hide-optional",
+     'O',
+     0,
+     G_OPTION_ARG_NONE,
+     &opts->hide_optional,
+     "Do not register optional audio/MIDI ports with JACK",
+     NULL},
     {"preset",
      'P',
      0,
@@ -86,6 +156,13 @@ jalv_frontend_init(int* argc, char*** argv, JalvOptions* opts)
      &opts->preset,
      "Load state from preset",
      "URI"},
+    {"meter-rate",
+     'R',
+     0,
+     G_OPTION_ARG_DOUBLE,
+     &opts->meter_rate,
+     "Meter audio levels at HZ",
+     "HZ"},
     {"scale-factor",
      'S',
      0,
@@ -93,6 +170,13 @@ jalv_frontend_init(int* argc, char*** argv, JalvOptions* opts)
      &opts->scale_factor,
      "UI scale factor",
      "SCALE"},
+    {"scope-tap",
+     'T',
+     0,
+     G_OPTION_ARG_STRING_ARRAY,
+     &opts->scope_taps,
+     "Capture the last N (decimated by D) frames of SYM",
+     "SYM=N:D"},
     {"ui-uri",
      'U',
      0,
@@ -100,6 +184,20 @@ jalv_frontend_init(int* argc, char*** argv, JalvOptions* opts)
      &opts->ui_uri,
      "Load the UI with the given URI",
      "URI"},
+    {"watchdog",
+     'W',
+     0,
+     G_OPTION_ARG_STRING,
+     &opts->watchdog,
+     "Bypass plugin for S seconds if it takes over F of the period N times",
+     "F:N:S"},
+    {"hide-port",
+     'X',
+     0,
+     G_OPTION_ARG_STRING_ARRAY,
+     &opts->hidden_ports,
+     "Do not register ports whose symbol matches PATTERN",
+     "PATTERN"},
     {"buffer-size",
      'b',
      0,
@@ -149,6 +247,13 @@ jalv_frontend_init(int* argc, char*** argv, JalvOptions* opts)
      &opts->name,
      "JACK client name",
      "NAME"},
+    {"oversample",
+     'o',
+     0,
+     G_OPTION_ARG_INT,
+     &opts->oversample,
+     "Run plugin at FACTOR (2 or 4) times the JACK rate",
+     "FACTOR"},
     {"print-controls",
      'p',
      0,
@@ -177,6 +282,20 @@ jalv_frontend_init(int* argc, char*** argv, JalvOptions* opts)
      &opts->trace,
      "Print trace messages from plugin",
      NULL},
+    {"port-frequency",
+     'u',
+     0,
+     G_OPTION_ARG_STRING_ARRAY,
+     &opts->port_rates,
+     "UI update frequency of output SYM",
+     "SYM=HZ"},
+    {"output-stage",
+     'w',
+     0,
+     G_OPTION_ARG_NONE,
+     &opts->output_stage,
+     "Add host dry/wet mix and output gain controls",
+     NULL},
     {"exact-jack-name",
      'x',
      0,
@@ -199,6 +318,10 @@ jalv_frontend_init(int* argc, char*** argv, JalvOptions* opts)
     fprintf(stderr, "%s\n", error->message);
   }
 
+  if (opts->dsp_cpu >= 0) {
+    opts->pipelined = true;
+  }
+
   return !err;
 }
 
@@ -827,6 +950,31 @@ jalv_ui_port_event(Jalv*       jalv,
   }
 }
 
+#if USE_PIPE
+static gboolean
+on_wakeup(gint ZIX_UNUSED(fd), GIOCondition ZIX_UNUSED(cond), gpointer data)
+{
+  Jalv* const jalv = (Jalv*)data;
+
+  jalv_wakeup_clear(jalv->wakeup);
+  return jalv_update(jalv) ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+#endif
+
+/// Call jalv_update() when woken by the plugin, or on a timer if unsupported
+static void
+add_update_source(Jalv* const jalv)
+{
+#if USE_PIPE
+  if (jalv->wakeup) {
+    g_unix_fd_add(jalv_wakeup_fd(jalv->wakeup), G_IO_IN, on_wakeup, jalv);
+    return;
+  }
+#endif
+
+  g_timeout_add(1000 / jalv->ui_update_hz, (GSourceFunc)jalv_update, jalv);
+}
+
 static gboolean
 scale_changed(GtkRange* range, gpointer data)
 {
@@ -1329,6 +1477,21 @@ jalv_frontend_scale_factor(Jalv* ZIX_UNUSED(jalv))
   return (float)gdk_monitor_get_scale_factor(monitor);
 }
 
+void
+jalv_frontend_subscribe(Jalv* jalv)
+{
+  // The generic UI only uses patch messages (of any object type) to show
+  // property values
+  for (uint32_t i = 0U; i < jalv->num_ports; ++i) {
+    const struct Port* const port = &jalv->ports[i];
+    if (port->flow == FLOW_OUTPUT && port->type == TYPE_EVENT) {
+      jalv_ui_subscribe(jalv, i, jalv->forge.Object);
+      jalv_ui_subscribe(jalv, i, jalv->forge.Blank);
+      jalv_ui_subscribe(jalv, i, jalv->forge.Resource);
+    }
+  }
+}
+
 static void
 on_row_activated(GtkTreeView* const       tree_view,
                  GtkTreePath* const       path,
@@ -1518,7 +1681,7 @@ jalv_frontend_open(Jalv* jalv)
 
   jalv_init_ui(jalv);
 
-  g_timeout_add(1000 / jalv->ui_update_hz, (GSourceFunc)jalv_update, jalv);
+  add_update_source(jalv);
 
   gtk_window_present(GTK_WINDOW(window));
 
@@ -1547,10 +1710,9 @@ jalv_print_controls(Jalv* jalv, bool writable, bool readable)
 		ControlID* const control = jalv->controls.controls[i];
 		if ((control->is_writable && writable) ||
 		    (control->is_readable && readable)) {
-			struct Port* const port = &jalv->ports[control->index];
 			printf("%s = %f\n",
 			       lilv_node_as_string(control->symbol),
-			       port->control);
+			       jalv_control_value(jalv, control));
 		}
 	}
 }
@@ -1571,6 +1733,10 @@ jalv_process_command(Jalv* jalv, const char* cmd)
 	char     sym[1024];
 	uint32_t index = 0;
 	float    value = 0.0f;
+	if (jalv_process_host_command(jalv, cmd)) {
+		return;
+	}
+
 	if (!strncmp(cmd, "help", 4)) {
 		fprintf(stderr,
 		        "Commands:\n"
@@ -1584,6 +1750,7 @@ jalv_process_command(Jalv* jalv, const char* cmd)
 		        "  set INDEX VALUE   Set control value by port index\n"
 		        "  set SYMBOL VALUE  Set control value by symbol\n"
 		        "  SYMBOL = VALUE    Set control value by symbol\n");
+		jalv_print_host_commands(stderr);
 	} else if (strcmp(cmd, "presets\n") == 0) {
 		jalv_unload_presets(jalv);
 		jalv_load_presets(jalv, jalv_print_preset, NULL);
@@ -1605,7 +1772,7 @@ jalv_process_command(Jalv* jalv, const char* cmd)
 		jalv_print_controls(jalv, false, true);
 	} else if (sscanf(cmd, "set %u %f", &index, &value) == 2) {
 		if (index < jalv->num_ports) {
-			jalv->ports[index].control = value;
+			jalv_write_control(jalv, jalv->ui_to_plugin, index, value);
 			jalv_print_control(jalv, &jalv->ports[index], value);
 		} else {
 			fprintf(stderr, "error: port index out of range\n");
@@ -1622,7 +1789,7 @@ jalv_process_command(Jalv* jalv, const char* cmd)
 			}
 		}
 		if (port) {
-			port->control = value;
+			jalv_write_control(jalv, jalv->ui_to_plugin, port->index, value);
 			jalv_print_control(jalv, port, value);
 		} else {
 			fprintf(stderr, "error: no control named `%s'\n", sym);
@@ -6,17 +6,26 @@
 
 #include "attributes.h"
 #include "control.h"
+#include "control_channel.h"
 #include "jalv_config.h"
 #include "log.h"
+#include "lv2_evbuf.h"
+#include "meter.h"
+#include "modulator.h"
 #include "nodes.h"
 #include "options.h"
+#include "ring.h"
+#include "scope.h"
+#include "stage.h"
 #include "symap.h"
 #include "types.h"
 #include "urids.h"
+#include "wakeup.h"
+#include "watchdog.h"
 #include "worker.h"
 
-#include "zix/ring.h"
 #include "zix/sem.h"
+#include "zix/thread.h"
 
 #include "lilv/lilv.h"
 #include "serd/serd.h"
@@ -75,15 +84,27 @@ struct JalvImpl {
   Symap*            symap;        ///< URI map
   ZixSem            symap_lock;   ///< Lock for URI map
   JalvBackend*      backend;      ///< Audio system backend
-  ZixRing*          ui_to_plugin; ///< Port events from UI
-  ZixRing*          plugin_to_ui; ///< Port events from plugin
-  void*             ui_event_buf; ///< Buffer for reading UI port events
+  JalvRing*         ui_priority;  ///< Priority port events from UI
+  JalvRing*         ui_to_plugin; ///< Bulk port events from UI
+  JalvRing*         plugin_to_ui; ///< Port events from plugin
+  JalvWakeup*       wakeup;       ///< Wakes the UI to read from the plugin
+  void*             ui_event_buf; ///< Buffer for reading all UI port events
+  void*             ui_seq_buf;   ///< Buffer for filtering events to the UI
+  uint32_t          ui_event_cap; ///< Size of ui_event_buf in bytes
+  uint64_t          cycle_last;   ///< Clock time of the previous cycle start
+  uint64_t          cycle_start;  ///< Clock time of the current cycle start
   JalvWorker*       worker;       ///< Worker thread implementation
   JalvWorker*       state_worker; ///< Synchronous worker for state restore
   ZixSem            work_lock;    ///< Lock for plugin work() method
   ZixSem            done;         ///< Exit semaphore
   ZixSem            paused;       ///< Paused signal from process thread
   JalvPlayState     play_state;   ///< Current play state
+  uint32_t          n_pauses;     ///< Number of pauses to restore state
+  uint64_t          pause_last;   ///< Duration of last pause in nanoseconds
+  uint64_t          pause_max;    ///< Longest pause in nanoseconds
+  uint32_t          drain_last;   ///< Number of UI port events last read
+  uint32_t          drain_max;    ///< Most UI port events read at once
+  uint32_t          drain_bytes;  ///< Most bytes of UI port events read at once
   char*             temp_dir;     ///< Temporary plugin state directory
   char*             save_dir;     ///< Plugin save directory
   const LilvPlugin* plugin;       ///< Plugin class (RDF data)
@@ -92,11 +113,22 @@ struct JalvImpl {
   const LilvUI*     ui;           ///< Plugin UI (RDF data)
   const LilvNode*   ui_type;      ///< Plugin UI type (unwrapped)
   LilvInstance*     instance;     ///< Plugin instance (shared library)
+  JalvStage*        stage;        ///< Host output stage, or null
+  JalvMeters*       meters;       ///< Audio level meters, or null
+  JalvModulators*   modulators;   ///< Control port modulators
+  JalvScope*        scope;        ///< Audio capture taps, or null
+  JalvWatchdog*     watchdog;     ///< Overrun watchdog, or null
+  ControlValue*     batch;        ///< Staged batch of control values, or null
+  uint32_t          n_batch;      ///< Number of values in batch
+  int               batches_sent; ///< Batches sent to the plugin
+  int               batches_done; ///< Batches applied by the plugin (atomic)
 #if USE_SUIL
   SuilHost*     ui_host;     ///< Plugin UI host support
   SuilInstance* ui_instance; ///< Plugin UI instance (shared library)
 #endif
   void*               window;          ///< Window (if applicable)
+  JalvControlChannel* ui_controls;     ///< Control values from UI
+  JalvControlChannel* plugin_controls; ///< Control values from plugin
   struct Port*        ports;           ///< Port array of size num_ports
   Controls            controls;        ///< Available plugin controls
   uint32_t            block_length;    ///< Audio buffer size (block length)
@@ -105,10 +137,14 @@ struct JalvImpl {
   uint32_t            num_ports;       ///< Size of the two following arrays:
   uint32_t            plugin_latency;  ///< Latency reported by plugin (if any)
   int32_t             bpm_port_index;  ///< Time BPM designated Control Port (index)
+  int32_t             enabled_port_index; ///< lv2:enabled port, or -1
   float               ui_update_hz;    ///< Frequency of UI updates
   float               ui_scale_factor; ///< UI scale factor
   float               sample_rate;     ///< Sample rate
-  uint32_t            event_delta_t;   ///< Frames since last update sent to UI
+  int                 n_updates_sent;  ///< Output changes sent to UI (atomic)
+  int                 n_updates_kept;  ///< Unchanged outputs not sent (atomic)
+  int                 ui_dirty;        ///< Plugin sent something to UI (atomic)
+  uint32_t            wakeup_due;      ///< Frames until the UI may be woken
   uint32_t            position;        ///< Transport position in frames
   float               bpm;             ///< Transport tempo in beats per minute
   bool                rolling;         ///< Transport speed (0=stop, 1=play)
@@ -116,6 +152,10 @@ struct JalvImpl {
   bool                has_ui;          ///< True iff a control UI is present
   bool                request_update;  ///< True iff a plugin update is needed
   bool                safe_restore;    ///< Plugin restore() is thread-safe
+  JalvWatchdogStatus  watchdog_status; ///< Last reported watchdog status
+  ZixSem              watchdog_sem;    ///< Posted when the watchdog trips
+  ZixThread           watchdog_thread; ///< Reports watchdog trips
+  int                 watchdog_exit;   ///< Stop the reporter thread (atomic)
   JalvFeatures        features;
   const LV2_Feature** feature_list;
 };
@@ -154,6 +194,61 @@ jalv_set_control(Jalv*            jalv,
                  LV2_URID         type,
                  const void*      body);
 
+/**
+   Begin a batch of control port values.
+
+   Values added to the batch with jalv_batch_set() are not sent to the plugin
+   until jalv_batch_commit() is called, which sends them all at once so they
+   are applied together in a single cycle.
+
+   @return Zero on success, or non-zero if a batch has already begun.
+*/
+int
+jalv_batch_begin(Jalv* jalv);
+
+/// Stage a control port value, replacing any previous value for the port
+int
+jalv_batch_set(Jalv* jalv, uint32_t port_index, float value);
+
+/// Send all staged values to the plugin and end the batch
+int
+jalv_batch_commit(Jalv* jalv);
+
+/// Discard all staged values and end the batch
+void
+jalv_batch_abort(Jalv* jalv);
+
+/// Return the current value of a port or host control, or 0 for properties
+float
+jalv_control_value(const Jalv* jalv, const ControlID* control);
+
+/**
+   Connect an audio or CV port to a buffer for this cycle.
+
+   Backends use this instead of lilv_instance_connect_port() for signal ports,
+   so that the output stage can find the buffers.  Realtime safe.
+*/
+void
+jalv_connect_audio_port(Jalv* jalv, uint32_t port_index, void* buf);
+
+/**
+   Subscribe the UI to events from a port.
+
+   Only events the UI is subscribed to are sent to it, so it doesn't get dense
+   streams like MIDI that it doesn't use.  This must be called before the
+   backend is activated.
+
+   @param jalv Jalv instance.
+   @param port_index Index of the output port.
+   @param type Type of events to send, or 0 for all types.
+*/
+void
+jalv_ui_subscribe(Jalv* jalv, uint32_t port_index, LV2_URID type);
+
+/// Return true if the UI is subscribed to an event from a port (realtime safe)
+bool
+jalv_ui_is_subscribed(const Jalv* jalv, uint32_t port_index, LV2_URID type);
+
 void
 jalv_init_ui(Jalv* jalv);
 
@@ -184,6 +279,8 @@ jalv_ui_port_event(Jalv*       jalv,
    Write a port event using the atom:eventTransfer protocol.
 
    This is used to transfer atoms between the plugin and UI via sequence ports.
+   Small patch:Set messages to the plugin are written to the priority ring
+   instead, so they aren't held up by large messages.
 
    @param jalv Jalv instance.
    @param target Communication ring (jalv->plugin_to_ui or jalv->ui_to_plugin).
@@ -195,17 +292,35 @@ jalv_ui_port_event(Jalv*       jalv,
 */
 int
 jalv_write_event(Jalv*       jalv,
-                 ZixRing*    target,
+                 JalvRing*   target,
                  uint32_t    port_index,
                  uint32_t    size,
                  LV2_URID    type,
                  const void* body);
 
+/**
+   Forward the events of an output sequence port to the UI (realtime safe).
+
+   All events the UI is subscribed to are written to the plugin to UI ring as
+   a single message, which jalv_update() unpacks into separate port events.
+
+   @param jalv Jalv instance.
+   @param port_index Index of the output event port.
+   @param evbuf Event buffer the plugin has written to.
+   @return 0 on success, non-zero on failure (overflow).
+*/
+int
+jalv_write_events(Jalv* jalv, uint32_t port_index, LV2_Evbuf* evbuf);
+
 /**
    Write a control port change using the default (0) protocol.
 
    This is used to transfer control port value changes between the plugin and
-   UI.
+   UI.  Rather than being written to the ring itself, the value is written to
+   the control channel of the same direction, so that only the latest value of
+   each port is read.  While a batch sent to the plugin hasn't been applied,
+   values to the plugin are queued after it instead, so they aren't overridden
+   by it.
 
    @param jalv Jalv instance.
    @param target Communication ring (jalv->plugin_to_ui or jalv->ui_to_plugin).
@@ -215,10 +330,20 @@ jalv_write_event(Jalv*       jalv,
 */
 int
 
-jalv_write_control(Jalv*    jalv,
-                   ZixRing* target,
-                   uint32_t port_index,
-                   float    value);
+jalv_write_control(Jalv*     jalv,
+                   JalvRing* target,
+                   uint32_t  port_index,
+                   float     value);
+
+/**
+   Send the value of an output control port to the UI if it is due and changed.
+
+   Each port is sent at its own update rate, when jalv_run() returns true.
+   Changes smaller than the resolution of the port, which depends on its range
+   and whether it is an integer or toggle, are not sent.  Realtime safe.
+*/
+void
+jalv_send_control_output(Jalv* jalv, uint32_t port_index);
 
 void
 jalv_dump_atom(Jalv*           jalv,
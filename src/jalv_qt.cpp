@@ -2,11 +2,13 @@
 // SPDX-License-Identifier: ISC
 
 #include "jalv_qt.hpp"
+#include "command.h"
 #include "frontend.h"
 #include "jalv_internal.h"
 #include "nodes.h"
 #include "options.h"
 #include "port.h"
+#include "wakeup.h"
 
 #include "lilv/lilv.h"
 #include "suil/suil.h"
@@ -34,6 +36,7 @@
 #include <QScrollArea>
 #include <QSize>
 #include <QSizePolicy>
+#include <QSocketNotifier>
 #include <QString>
 #include <QStyle>
 #include <QTimer>
@@ -280,6 +283,7 @@ int
 jalv_frontend_init(int* argc, char*** argv, JalvOptions* opts)
 {
   opts->preset_path = jalv_get_working_dir();
+  opts->dsp_cpu     = -1;
 
   app = new QApplication(*argc, *argv, true);
   app->setStyleSheet("QGroupBox::title { subcontrol-position: top center }");
@@ -344,6 +348,7 @@ Control::Control(PortContainer portContainer, QWidget* parent)
   , dial(new QDial())
   , plugin(portContainer.jalv->plugin)
   , port(portContainer.port)
+  , jalv(portContainer.jalv)
   , label(new QLabel())
 {
   JalvNodes*      nodes    = &portContainer.jalv->nodes;
@@ -531,7 +536,7 @@ Control::dialChanged(int)
   const float value = getValue();
 
   label->setText(getValueLabel(value));
-  port->control = value;
+  jalv_write_control(jalv, jalv->ui_to_plugin, port->index, value);
 }
 
 static bool
@@ -641,6 +646,12 @@ jalv_frontend_scale_factor(Jalv*)
     QGuiApplication::primaryScreen()->devicePixelRatio());
 }
 
+void
+jalv_frontend_subscribe(Jalv*)
+{
+  // The generic UI only shows control ports, which don't need events
+}
+
 LilvNode*
 jalv_frontend_select_plugin(Jalv*)
 {
@@ -718,8 +729,19 @@ jalv_frontend_open(Jalv* jalv)
     win->resize(widget->width(), widget->height() + win->menuBar()->height());
   }
 
-  auto* const timer = new Timer(jalv);
-  timer->start(1000 / jalv->ui_update_hz);
+  if (jalv->wakeup) {
+    // Update only when the process thread has sent something
+    auto* const notifier = new QSocketNotifier(
+      jalv_wakeup_fd(jalv->wakeup), QSocketNotifier::Read, app);
+
+    QObject::connect(notifier, &QSocketNotifier::activated, [jalv]() {
+      jalv_wakeup_clear(jalv->wakeup);
+      jalv_update(jalv);
+    });
+  } else {
+    auto* const timer = new Timer(jalv);
+    timer->start(1000 / jalv->ui_update_hz);
+  }
 
   init_cli_thread(jalv);
   const int ret = app->exec();
@@ -744,10 +766,9 @@ jalv_print_controls(Jalv* jalv, bool writable, bool readable)
 		ControlID* const control = jalv->controls.controls[i];
 		if ((control->is_writable && writable) ||
 		    (control->is_readable && readable)) {
-			struct Port* const port = &jalv->ports[control->index];
 			printf("%s = %f\n",
 			       lilv_node_as_string(control->symbol),
-			       port->control);
+			       jalv_control_value(jalv, control));
 		}
 	}
 }
@@ -768,6 +789,10 @@ jalv_process_command(Jalv* jalv, const char* cmd)
 	char     sym[1024];
 	uint32_t index = 0;
 	float    value = 0.0f;
+	if (jalv_process_host_command(jalv, cmd)) {
+		return;
+	}
+
 	if (!strncmp(cmd, "help", 4)) {
 		fprintf(stderr,
 		        "Commands:\n"
@@ -781,6 +806,7 @@ jalv_process_command(Jalv* jalv, const char* cmd)
 		        "  set INDEX VALUE   Set control value by port index\n"
 		        "  set SYMBOL VALUE  Set control value by symbol\n"
 		        "  SYMBOL = VALUE    Set control value by symbol\n");
+		jalv_print_host_commands(stderr);
 	} else if (strcmp(cmd, "presets\n") == 0) {
 		jalv_unload_presets(jalv);
 		jalv_load_presets(jalv, jalv_print_preset, NULL);
@@ -799,7 +825,7 @@ jalv_process_command(Jalv* jalv, const char* cmd)
 		jalv_print_controls(jalv, false, true);
 	} else if (sscanf(cmd, "set %u %f", &index, &value) == 2) {
 		if (index < jalv->num_ports) {
-			jalv->ports[index].control = value;
+			jalv_write_control(jalv, jalv->ui_to_plugin, index, value);
 			jalv_print_control(jalv, &jalv->ports[index], value);
 		} else {
 			fprintf(stderr, "error: port index out of range\n");
@@ -816,7 +842,7 @@ jalv_process_command(Jalv* jalv, const char* cmd)
 			}
 		}
 		if (port) {
-			port->control = value;
+			jalv_write_control(jalv, jalv->ui_to_plugin, port->index, value);
 			jalv_print_control(jalv, port, value);
 		} else {
 			fprintf(stderr, "error: no control named `%s'\n", sym);
@@ -65,6 +65,7 @@ private:
   QDial*            dial;
   const LilvPlugin* plugin;
   Port*             port;
+  Jalv*             jalv;
 
   QLabel* label;
   QString name;
@@ -65,6 +65,25 @@ lv2_evbuf_reset(LV2_Evbuf* evbuf, bool input)
   }
 }
 
+bool
+lv2_evbuf_copy(LV2_Evbuf* dst, const LV2_Evbuf* src)
+{
+  if (src->buf.atom.type != src->atom_Sequence) {
+    // Output buffer the plugin has not written to, copy as empty
+    lv2_evbuf_reset(dst, false);
+    return true;
+  }
+
+  if (src->buf.atom.size > dst->capacity) {
+    lv2_evbuf_reset(dst, true);
+    return false;
+  }
+
+  memcpy(&dst->buf, &src->buf, sizeof(LV2_Atom) + src->buf.atom.size);
+  dst->buf.atom.type = dst->atom_Sequence;
+  return true;
+}
+
 uint32_t
 lv2_evbuf_get_size(LV2_Evbuf* evbuf)
 {
@@ -181,3 +200,34 @@ lv2_evbuf_write(LV2_Evbuf_Iterator* iter,
 
   return true;
 }
+
+bool
+lv2_evbuf_insert(LV2_Evbuf*  evbuf,
+                 uint32_t    frames,
+                 uint32_t    subframes,
+                 uint32_t    type,
+                 uint32_t    size,
+                 const void* data)
+{
+  LV2_Atom_Sequence* aseq = &evbuf->buf;
+  char* contents = (char*)LV2_ATOM_CONTENTS(LV2_Atom_Sequence, aseq);
+
+  // Find the first event that is later than the new one
+  LV2_Evbuf_Iterator iter = lv2_evbuf_begin(evbuf);
+  while (lv2_evbuf_is_valid(iter) &&
+         ((LV2_Atom_Event*)(contents + iter.offset))->time.frames <= frames) {
+    iter = lv2_evbuf_next(iter);
+  }
+
+  const uint32_t padded = lv2_atom_pad_size(sizeof(LV2_Atom_Event) + size);
+  if (evbuf->capacity - sizeof(LV2_Atom) - aseq->atom.size < padded) {
+    return false;
+  }
+
+  // Move any later events out of the way, then write into the gap
+  memmove(contents + iter.offset + padded,
+          contents + iter.offset,
+          lv2_evbuf_get_size(evbuf) - iter.offset);
+
+  return lv2_evbuf_write(&iter, frames, subframes, type, size, data);
+}
@@ -44,6 +44,17 @@ lv2_evbuf_free(LV2_Evbuf* evbuf);
 void
 lv2_evbuf_reset(LV2_Evbuf* evbuf, bool input);
 
+/**
+   Copy the contents of one event buffer to another.
+
+   This copies the events and the state of the buffer (input or output), so
+   `dst` can be used in place of `src`.  Both buffers must use the same URIDs.
+
+   @return True on success, or false if `dst` is too small (and now empty).
+*/
+bool
+lv2_evbuf_copy(LV2_Evbuf* dst, const LV2_Evbuf* src);
+
 /// Return the total padded size of the events stored in the buffer
 uint32_t
 lv2_evbuf_get_size(LV2_Evbuf* evbuf);
@@ -116,6 +127,22 @@ lv2_evbuf_write(LV2_Evbuf_Iterator* iter,
                 uint32_t            size,
                 const void*         data);
 
+/**
+   Insert an event in time order.
+
+   The event is inserted after any events at the same or earlier times, so
+   events at the same time stay in the order they were inserted.
+
+   @return True if event was written, otherwise false (buffer is full).
+*/
+bool
+lv2_evbuf_insert(LV2_Evbuf*  evbuf,
+                 uint32_t    frames,
+                 uint32_t    subframes,
+                 uint32_t    type,
+                 uint32_t    size,
+                 const void* data);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,367 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+#include "meter.h"
+
+#include "dsp.h"
+#include "triple_buffer.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifndef M_PI
+#  define M_PI 3.14159265358979323846
+#endif
+
+/// Number of 100 ms blocks in the short-term loudness window
+#define JALV_METER_N_BINS 30U
+
+/// Biquad filter coefficients (normalised so a0 is 1)
+typedef struct {
+  double b0, b1, b2, a1, a2;
+} JalvBiquad;
+
+/// Biquad filter state (transposed direct form II)
+typedef struct {
+  double z1, z2;
+} JalvBiquadState;
+
+typedef struct {
+  uint32_t        port;                    ///< Port index
+  const float*    buf;                     ///< Connected buffer, or null
+  float           peak;                    ///< Peak over this period
+  double          sum;                     ///< Sum of squares this period
+  JalvBiquadState filters[2];              ///< K-weighting filter state
+  double          bin_sum;                 ///< Weighted sum of squares this bin
+  double          bins[JALV_METER_N_BINS]; ///< Mean square of recent bins
+} JalvMeter;
+
+struct JalvMetersImpl {
+  JalvMeter*        meters;      ///< Meter for each metered port
+  uint32_t          n_meters;    ///< Number of meters
+  uint32_t          n_ports;     ///< Number of plugin ports
+  uint32_t*         port_meters; ///< Meter index for each port, or UINT32_MAX
+  JalvTripleBuffer* levels;      ///< Published array of levels
+  uint32_t          period;      ///< Frames per published update
+  uint32_t          elapsed;     ///< Frames since the last update
+  bool              loudness;    ///< Measure short-term loudness
+  JalvBiquad        shelf;       ///< K-weighting high shelf
+  JalvBiquad        highpass;    ///< K-weighting high pass
+  uint32_t          bin_length;  ///< Frames in each loudness bin
+  uint32_t          bin_elapsed; ///< Frames in the current bin
+  uint32_t          bin_index;   ///< Index of the current bin
+  uint32_t          n_bins;      ///< Number of complete bins, up to the max
+};
+
+/// Set up the two K-weighting filters of ITU-R BS.1770 for a sample rate
+static void
+jalv_meters_init_k_weighting(JalvMeters* const meters, const double rate)
+{
+  // High shelf modelling the acoustic effect of the head
+  const double f0 = 1681.974450955533;
+  const double g  = 3.999843853973347;
+  const double q  = 0.7071752369554196;
+  const double k  = tan(M_PI * f0 / rate);
+  const double vh = pow(10.0, g / 20.0);
+  const double vb = pow(vh, 0.4996667741545416);
+  const double a0 = 1.0 + k / q + k * k;
+
+  meters->shelf.b0 = (vh + vb * k / q + k * k) / a0;
+  meters->shelf.b1 = 2.0 * (k * k - vh) / a0;
+  meters->shelf.b2 = (vh - vb * k / q + k * k) / a0;
+  meters->shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+  meters->shelf.a2 = (1.0 - k / q + k * k) / a0;
+
+  // High pass (the RLB weighting curve)
+  const double hf0 = 38.13547087602444;
+  const double hq  = 0.5003270373238773;
+  const double hk  = tan(M_PI * hf0 / rate);
+  const double ha0 = 1.0 + hk / hq + hk * hk;
+
+  meters->highpass.b0 = 1.0;
+  meters->highpass.b1 = -2.0;
+  meters->highpass.b2 = 1.0;
+  meters->highpass.a1 = 2.0 * (hk * hk - 1.0) / ha0;
+  meters->highpass.a2 = (1.0 - hk / hq + hk * hk) / ha0;
+}
+
+JalvMeters*
+jalv_meters_new(const uint32_t* const ports,
+                const uint32_t        n_meters,
+                const uint32_t        n_ports,
+                const float           sample_rate,
+                const float           update_hz,
+                const bool            loudness)
+{
+  JalvMeters* const meters = (JalvMeters*)calloc(1, sizeof(JalvMeters));
+  if (!meters) {
+    return NULL;
+  }
+
+  meters->n_meters = n_meters;
+  meters->n_ports  = n_ports;
+  meters->meters   = (JalvMeter*)calloc(n_meters + 1U, sizeof(JalvMeter));
+  meters->port_meters = (uint32_t*)calloc(n_ports + 1U, sizeof(uint32_t));
+  meters->levels =
+    jalv_triple_buffer_new((n_meters + 1U) * sizeof(JalvLevel));
+
+  if (!meters->meters || !meters->port_meters || !meters->levels) {
+    jalv_meters_free(meters);
+    return NULL;
+  }
+
+  for (uint32_t p = 0U; p < n_ports; ++p) {
+    meters->port_meters[p] = UINT32_MAX;
+  }
+
+  for (uint32_t m = 0U; m < n_meters; ++m) {
+    meters->meters[m].port = ports[m];
+    if (ports[m] < n_ports) {
+      meters->port_meters[ports[m]] = m;
+    }
+  }
+
+  const float period = sample_rate / (update_hz > 0.0f ? update_hz : 1.0f);
+
+  meters->period     = period < 1.0f ? 1U : (uint32_t)period;
+  meters->loudness   = loudness;
+  meters->bin_length = (uint32_t)(sample_rate / 10.0f);
+  meters->bin_length = meters->bin_length ? meters->bin_length : 1U;
+  jalv_meters_init_k_weighting(meters, sample_rate);
+  return meters;
+}
+
+void
+jalv_meters_free(JalvMeters* const meters)
+{
+  if (meters) {
+    jalv_triple_buffer_free(meters->levels);
+    free(meters->port_meters);
+    free(meters->meters);
+    free(meters);
+  }
+}
+
+uint32_t
+jalv_meters_count(const JalvMeters* const meters)
+{
+  return meters->n_meters;
+}
+
+uint32_t
+jalv_meters_port(const JalvMeters* const meters, const uint32_t meter)
+{
+  return meters->meters[meter].port;
+}
+
+void
+jalv_meters_connect(JalvMeters* const meters,
+                    const uint32_t    port_index,
+                    const void* const buf)
+{
+  if (port_index < meters->n_ports) {
+    const uint32_t m = meters->port_meters[port_index];
+    if (m != UINT32_MAX) {
+      meters->meters[m].buf = (const float*)buf;
+    }
+  }
+}
+
+/// Run a biquad filter on one sample
+static inline double
+jalv_biquad_run(const JalvBiquad* const f,
+                JalvBiquadState* const  s,
+                const double            x)
+{
+  const double y = f->b0 * x + s->z1;
+
+  s->z1 = f->b1 * x - f->a1 * y + s->z2;
+  s->z2 = f->b2 * x - f->a2 * y;
+  return y;
+}
+
+/// Accumulate the K-weighted power of a segment of input
+static void
+jalv_meters_weigh(const JalvMeters* const meters,
+                  JalvMeter* const        meter,
+                  const float* const      buf,
+                  const uint32_t          n_frames)
+{
+  double sum = 0.0;
+  for (uint32_t i = 0U; i < n_frames; ++i) {
+    const double x = buf ? (double)buf[i] : 0.0;
+    const double s = jalv_biquad_run(&meters->shelf, &meter->filters[0], x);
+    const double y = jalv_biquad_run(&meters->highpass, &meter->filters[1], s);
+    sum += y * y;
+  }
+
+  meter->bin_sum += sum;
+}
+
+/// Return the short-term loudness of a meter in LUFS
+static float
+jalv_meter_loudness(const JalvMeters* const meters,
+                    const JalvMeter* const  meter)
+{
+  if (!meters->n_bins) {
+    return -INFINITY;
+  }
+
+  double sum = 0.0;
+  for (uint32_t b = 0U; b < meters->n_bins; ++b) {
+    sum += meter->bins[b];
+  }
+
+  const double mean = sum / meters->n_bins;
+  return mean > 0.0 ? (float)(-0.691 + 10.0 * log10(mean)) : -INFINITY;
+}
+
+/// Publish the levels for the period that just finished and start another
+static void
+jalv_meters_publish(JalvMeters* const meters)
+{
+  JalvLevel* const levels =
+    (JalvLevel*)jalv_triple_buffer_write_begin(meters->levels);
+
+  for (uint32_t m = 0U; m < meters->n_meters; ++m) {
+    JalvMeter* const meter = &meters->meters[m];
+
+    levels[m].peak = meter->peak;
+    levels[m].rms  = (float)sqrt(meter->sum / meters->elapsed);
+    levels[m].loudness =
+      meters->loudness ? jalv_meter_loudness(meters, meter) : NAN;
+
+    meter->peak = 0.0f;
+    meter->sum  = 0.0;
+  }
+
+  jalv_triple_buffer_write_end(meters->levels);
+  meters->elapsed = 0U;
+}
+
+/// Finish the current loudness bin and start another
+static void
+jalv_meters_next_bin(JalvMeters* const meters)
+{
+  for (uint32_t m = 0U; m < meters->n_meters; ++m) {
+    JalvMeter* const meter = &meters->meters[m];
+
+    meter->bins[meters->bin_index] = meter->bin_sum / meters->bin_length;
+    meter->bin_sum                 = 0.0;
+  }
+
+  meters->bin_index   = (meters->bin_index + 1U) % JALV_METER_N_BINS;
+  meters->n_bins      = meters->n_bins < JALV_METER_N_BINS ? meters->n_bins + 1U
+                                                           : JALV_METER_N_BINS;
+  meters->bin_elapsed = 0U;
+}
+
+void
+jalv_meters_run(JalvMeters* const meters, const uint32_t n_frames)
+{
+  uint32_t offset = 0U;
+  while (offset < n_frames) {
+    // Process up to the next period or bin boundary
+    uint32_t n = n_frames - offset;
+    if (n > meters->period - meters->elapsed) {
+      n = meters->period - meters->elapsed;
+    }
+    if (meters->loudness && n > meters->bin_length - meters->bin_elapsed) {
+      n = meters->bin_length - meters->bin_elapsed;
+    }
+
+    for (uint32_t m = 0U; m < meters->n_meters; ++m) {
+      JalvMeter* const   meter = &meters->meters[m];
+      const float* const buf   = meter->buf ? meter->buf + offset : NULL;
+      if (buf) {
+        const float peak = jalv_dsp_peak(buf, n);
+
+        meter->peak = peak > meter->peak ? peak : meter->peak;
+        meter->sum += (double)jalv_dsp_dot(buf, buf, n);
+      }
+
+      if (meters->loudness) {
+        jalv_meters_weigh(meters, meter, buf, n);
+      }
+    }
+
+    offset += n;
+    if ((meters->elapsed += n) == meters->period) {
+      jalv_meters_publish(meters);
+    }
+
+    if (meters->loudness &&
+        (meters->bin_elapsed += n) == meters->bin_length) {
+      jalv_meters_next_bin(meters);
+    }
+  }
+}
+
+const JalvLevel*
+jalv_meters_read(JalvMeters* const meters, bool* const fresh)
+{
+  return (const JalvLevel*)jalv_triple_buffer_read(meters->levels, fresh);
+}
+
+#ifdef METER_STANDALONE
+
+#  include <stdio.h>
+
+#  define TEST_RATE 48000.0f
+#  define TEST_BLOCK 256U
+
+int
+main(void)
+{
+  const uint32_t    ports[] = {1U};
+  JalvMeters* const meters =
+    jalv_meters_new(ports, 1U, 2U, TEST_RATE, 10.0f, true);
+  if (!meters) {
+    return fprintf(stderr, "error: Failed to create meters\n");
+  }
+
+  // Nothing has been published yet
+  bool fresh = true;
+  if (jalv_meters_read(meters, &fresh)[0].peak != 0.0f || fresh) {
+    return fprintf(stderr, "error: Levels published too early\n");
+  }
+
+  // Meter 4 seconds of a full scale 997 Hz sine
+  float buf[TEST_BLOCK];
+  jalv_meters_connect(meters, 1U, buf);
+  for (uint32_t b = 0U; b < (uint32_t)(4.0f * TEST_RATE) / TEST_BLOCK; ++b) {
+    for (uint32_t i = 0U; i < TEST_BLOCK; ++i) {
+      const double t = (double)(b * TEST_BLOCK + i) / (double)TEST_RATE;
+      buf[i]         = (float)sin(2.0 * M_PI * 997.0 * t);
+    }
+
+    jalv_meters_run(meters, TEST_BLOCK);
+  }
+
+  const JalvLevel* const level = jalv_meters_read(meters, &fresh);
+
+  int st = 0;
+  if (!fresh) {
+    st = fprintf(stderr, "error: Levels not published\n");
+  } else if (fabsf(level->peak - 1.0f) > 1.0e-3f) {
+    st = fprintf(stderr, "error: Peak %f is not 1\n", (double)level->peak);
+  } else if (fabsf(level->rms - sqrtf(0.5f)) > 1.0e-3f) {
+    st = fprintf(stderr, "error: RMS %f is not 0.707\n", (double)level->rms);
+  } else if (fabsf(level->loudness + 3.01f) > 0.05f) {
+    // A full scale 997 Hz sine in one channel is -3.01 LUFS
+    st = fprintf(
+      stderr, "error: Loudness %f is not -3.01\n", (double)level->loudness);
+  }
+
+  jalv_meters_read(meters, &fresh);
+  if (!st && fresh) {
+    st = fprintf(stderr, "error: Levels fresh after being read\n");
+  }
+
+  jalv_meters_free(meters);
+  return st;
+}
+
+#endif // METER_STANDALONE
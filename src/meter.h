@@ -0,0 +1,80 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+/**
+   @file meter.h Audio level meters for plugin ports.
+
+   Levels are measured in the process thread, and published at a fixed rate
+   through a triple buffer, so a reader never blocks the audio thread and
+   always sees a consistent set of levels.
+*/
+
+#ifndef JALV_METER_H
+#define JALV_METER_H
+
+#include "attributes.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+JALV_BEGIN_DECLS
+
+/// Level of an audio port, measured over one metering period
+typedef struct {
+  float peak;     ///< Peak absolute sample value
+  float rms;      ///< Root mean square sample value
+  float loudness; ///< Short-term (3 second) loudness in LUFS, or NAN
+} JalvLevel;
+
+typedef struct JalvMetersImpl JalvMeters;
+
+/**
+   Create meters for some plugin ports.
+
+   @param ports Indices of the ports to meter.
+   @param n_meters Number of ports to meter.
+   @param n_ports Total number of plugin ports.
+   @param sample_rate Sample rate of the plugin.
+   @param update_hz Rate to publish levels in Hz.
+   @param loudness Measure K-weighted short-term loudness as well.
+*/
+JalvMeters*
+jalv_meters_new(const uint32_t* ports,
+                uint32_t        n_meters,
+                uint32_t        n_ports,
+                float           sample_rate,
+                float           update_hz,
+                bool            loudness);
+
+/// Free meters
+void
+jalv_meters_free(JalvMeters* meters);
+
+/// Return the number of metered ports
+uint32_t
+jalv_meters_count(const JalvMeters* meters);
+
+/// Return the index of the port measured by a meter
+uint32_t
+jalv_meters_port(const JalvMeters* meters, uint32_t meter);
+
+/// Note the buffer connected to a plugin port (realtime safe)
+void
+jalv_meters_connect(JalvMeters* meters, uint32_t port_index, const void* buf);
+
+/// Measure one cycle of audio after the plugin has run (realtime safe)
+void
+jalv_meters_run(JalvMeters* meters, uint32_t n_frames);
+
+/**
+   Return the latest levels for all meters.
+
+   This never blocks, but must only be called from one thread.  If `fresh` is
+   not null, it is set to true if the levels have changed since the last call.
+*/
+const JalvLevel*
+jalv_meters_read(JalvMeters* meters, bool* fresh);
+
+JALV_END_DECLS
+
+#endif // JALV_METER_H
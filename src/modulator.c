@@ -0,0 +1,433 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+#include "modulator.h"
+
+#include "atomic.h"
+#include "dsp.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// Number of reductions of host inputs, which are all calculated each cycle
+#define JALV_N_REDUCTIONS 3U
+
+/// Maximum number of changes queued for the process thread at once
+#define JALV_MOD_QUEUE_SIZE 64U
+
+#ifndef M_PI
+#  define M_PI 3.14159265358979323846
+#endif
+
+typedef struct {
+  JalvModSettings settings; ///< Settings
+  float*          target;   ///< Value of target control port, or null if unused
+  double          phase;    ///< LFO phase or ramp position from 0 to 1
+  float           envelope; ///< Current envelope level
+  float           attack;   ///< Envelope attack coefficient
+  float           release;  ///< Envelope release coefficient
+} JalvModulator;
+
+/// A change to a modulator slot, sent from the UI thread to the process thread
+typedef struct {
+  JalvModSettings settings; ///< New settings
+  float*          target;   ///< New target, or null to stop the modulator
+  float           attack;   ///< Envelope attack coefficient
+  float           release;  ///< Envelope release coefficient
+  uint32_t        slot;     ///< Index of the slot to change
+} JalvModChange;
+
+struct JalvModulatorsImpl {
+  JalvModulator   slots[JALV_MAX_MODULATORS];    ///< Used by process thread
+  JalvModSettings settings[JALV_MAX_MODULATORS]; ///< Used by UI thread
+  bool            used[JALV_MAX_MODULATORS];     ///< Used by UI thread
+  JalvModChange   queue[JALV_MOD_QUEUE_SIZE];    ///< Changes to apply
+  uint32_t        head;        ///< Number of changes written (atomic)
+  uint32_t        tail;        ///< Number of changes applied (atomic)
+  const float**   inputs;      ///< Buffer of each port, or null
+  float*          levels;      ///< Reductions of host inputs
+  uint32_t        n_ports;     ///< Number of plugin ports
+  float           sample_rate; ///< Sample rate in Hz
+};
+
+JalvModulators*
+jalv_modulators_new(const uint32_t n_ports, const float sample_rate)
+{
+  JalvModulators* const modulators =
+    (JalvModulators*)calloc(1, sizeof(JalvModulators));
+  if (!modulators) {
+    return NULL;
+  }
+
+  modulators->inputs =
+    (const float**)calloc(n_ports + 1U, sizeof(const float*));
+  modulators->levels =
+    (float*)calloc((n_ports + 1U) * JALV_N_REDUCTIONS, sizeof(float));
+  if (!modulators->inputs || !modulators->levels) {
+    jalv_modulators_free(modulators);
+    return NULL;
+  }
+
+  modulators->n_ports     = n_ports;
+  modulators->sample_rate = sample_rate;
+  return modulators;
+}
+
+void
+jalv_modulators_free(JalvModulators* const modulators)
+{
+  if (modulators) {
+    free(modulators->inputs);
+    free(modulators->levels);
+    free(modulators);
+  }
+}
+
+/// Return the coefficient of a one-pole smoother with time constant `time`
+static float
+jalv_modulators_coefficient(const JalvModulators* const modulators,
+                            const float                 time)
+{
+  return time > 0.0f ? expf(-1.0f / (time * modulators->sample_rate)) : 0.0f;
+}
+
+/// Queue a change to a slot for the process thread, or fail if full
+static int
+jalv_modulators_push(JalvModulators* const        modulators,
+                     const uint32_t               slot,
+                     const JalvModSettings* const settings,
+                     float* const                 target)
+{
+  // Only this thread writes the head, so it doesn't need to be loaded
+  const uint32_t head = modulators->head;
+  if (head - JALV_ATOMIC_LOAD(&modulators->tail) >= JALV_MOD_QUEUE_SIZE) {
+    return 1;
+  }
+
+  JalvModChange* const change = &modulators->queue[head % JALV_MOD_QUEUE_SIZE];
+
+  change->slot   = slot;
+  change->target = target;
+  if (settings) {
+    change->settings = *settings;
+    change->attack   = jalv_modulators_coefficient(modulators, settings->time);
+    change->release =
+      jalv_modulators_coefficient(modulators, settings->release);
+  }
+
+  JALV_ATOMIC_STORE(&modulators->head, head + 1U);
+  return 0;
+}
+
+/// Apply all queued changes at the start of a cycle
+static void
+jalv_modulators_apply_changes(JalvModulators* const modulators)
+{
+  const uint32_t head = JALV_ATOMIC_LOAD(&modulators->head);
+  for (uint32_t t = modulators->tail; t != head; ++t) {
+    const JalvModChange* const change =
+      &modulators->queue[t % JALV_MOD_QUEUE_SIZE];
+
+    JalvModulator* const mod = &modulators->slots[change->slot];
+
+    mod->target = change->target;
+    if (mod->target) {
+      mod->settings = change->settings;
+      mod->phase    = 0.0;
+      mod->envelope = 0.0f;
+      mod->attack   = change->attack;
+      mod->release  = change->release;
+    }
+  }
+
+  JALV_ATOMIC_STORE(&modulators->tail, head);
+}
+
+int
+jalv_modulators_set(JalvModulators* const        modulators,
+                    const JalvModSettings* const settings,
+                    float* const                 target)
+{
+  if (settings->target >= modulators->n_ports ||
+      (settings->type == JALV_MOD_ENVELOPE &&
+       settings->source >= modulators->n_ports)) {
+    return 1;
+  }
+
+  // Stop any existing modulator for this port, so the slot can be reused
+  jalv_modulators_clear(modulators, settings->target);
+
+  for (uint32_t i = 0U; i < JALV_MAX_MODULATORS; ++i) {
+    if (!modulators->used[i]) {
+      if (jalv_modulators_push(modulators, i, settings, target)) {
+        return 1;
+      }
+
+      modulators->settings[i] = *settings;
+      modulators->used[i]     = true;
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+bool
+jalv_modulators_clear(JalvModulators* const modulators, const uint32_t target)
+{
+  bool found = false;
+  for (uint32_t i = 0U; i < JALV_MAX_MODULATORS; ++i) {
+    if (modulators->used[i] && modulators->settings[i].target == target &&
+        !jalv_modulators_push(modulators, i, NULL, NULL)) {
+      modulators->used[i] = false;
+      found               = true;
+    }
+  }
+
+  return found;
+}
+
+const JalvModSettings*
+jalv_modulators_get(const JalvModulators* const modulators, const uint32_t slot)
+{
+  return modulators->used[slot] ? &modulators->settings[slot] : NULL;
+}
+
+void
+jalv_modulators_connect(JalvModulators* const modulators,
+                        const uint32_t        port_index,
+                        const void* const     buf)
+{
+  if (port_index < modulators->n_ports) {
+    modulators->inputs[port_index] = (const float*)buf;
+  }
+}
+
+void
+jalv_modulators_read_input(JalvModulators* const modulators,
+                           const uint32_t        port_index,
+                           const float* const    buf,
+                           const uint32_t        n_frames)
+{
+  if (port_index >= modulators->n_ports || !n_frames) {
+    return;
+  }
+
+  float sum = 0.0f;
+  for (uint32_t i = 0U; i < n_frames; ++i) {
+    sum += buf[i];
+  }
+
+  float* const levels = modulators->levels + port_index * JALV_N_REDUCTIONS;
+
+  levels[JALV_REDUCE_MEAN] = sum / (float)n_frames;
+  levels[JALV_REDUCE_PEAK] = jalv_dsp_peak(buf, n_frames);
+  levels[JALV_REDUCE_LAST] = buf[n_frames - 1U];
+}
+
+/// Return the value of an LFO waveform at a phase from 0 to 1
+static float
+jalv_lfo_value(const JalvLfoShape shape, const double phase)
+{
+  switch (shape) {
+  case JALV_LFO_SINE:
+    return (float)sin(2.0 * M_PI * phase);
+  case JALV_LFO_TRIANGLE:
+    return (float)(1.0 - 4.0 * fabs(phase - 0.5));
+  case JALV_LFO_SAW:
+    return (float)(2.0 * phase - 1.0);
+  case JALV_LFO_SQUARE:
+    return phase < 0.5 ? 1.0f : -1.0f;
+  }
+
+  return 0.0f;
+}
+
+/// Advance a modulator by a cycle and return its modulation signal
+static float
+jalv_modulator_tick(const JalvModulators* const modulators,
+                    JalvModulator* const        mod,
+                    const uint32_t              n_frames)
+{
+  const JalvModSettings* const settings = &mod->settings;
+  const double                 time     = (double)settings->time;
+  const double                 seconds =
+    (double)n_frames / (double)modulators->sample_rate;
+
+  float value = 0.0f;
+  switch (settings->type) {
+  case JALV_MOD_LFO:
+    value      = jalv_lfo_value(settings->shape, mod->phase);
+    mod->phase = fmod(mod->phase + time * seconds, 1.0);
+    break;
+
+  case JALV_MOD_RAMP:
+    value      = (float)mod->phase;
+    mod->phase = time > 0.0 ? mod->phase + seconds / time : 1.0;
+    mod->phase = mod->phase < 1.0 ? mod->phase : 1.0;
+    break;
+
+  case JALV_MOD_ENVELOPE: {
+    const float* const input = modulators->inputs[settings->source];
+    float              env   = mod->envelope;
+    for (uint32_t i = 0U; input && i < n_frames; ++i) {
+      const float level = fabsf(input[i]);
+      const float coef  = level > env ? mod->attack : mod->release;
+      env               = level + coef * (env - level);
+    }
+
+    mod->envelope = env;
+    value         = env < 1.0f ? env : 1.0f;
+    break;
+  }
+
+  case JALV_MOD_INPUT: {
+    // Smooth the reduced level of each cycle with a one-pole filter
+    const float* const levels =
+      modulators->levels + settings->target * JALV_N_REDUCTIONS;
+    const float level = levels[settings->reduction];
+    const float coef =
+      settings->time > 0.0f ? expf((float)-seconds / settings->time) : 0.0f;
+
+    mod->envelope = level + coef * (mod->envelope - level);
+    value         = mod->envelope;
+    break;
+  }
+  }
+
+  return value;
+}
+
+void
+jalv_modulators_run(JalvModulators* const modulators, const uint32_t n_frames)
+{
+  jalv_modulators_apply_changes(modulators);
+
+  for (uint32_t i = 0U; i < JALV_MAX_MODULATORS; ++i) {
+    JalvModulator* const mod = &modulators->slots[i];
+    if (mod->target) {
+      const JalvModSettings* const settings = &mod->settings;
+
+      const float signal = jalv_modulator_tick(modulators, mod, n_frames);
+      const float amount = settings->offset + settings->depth * signal;
+      const float clamped =
+        amount < 0.0f ? 0.0f : (amount > 1.0f ? 1.0f : amount);
+
+      *mod->target = settings->min + (settings->max - settings->min) * clamped;
+    }
+  }
+}
+
+#ifdef MODULATOR_STANDALONE
+
+#  include <stdio.h>
+
+static int
+check(const char* const name, const float value, const float expected)
+{
+  if (fabsf(value - expected) > 1.0e-4f) {
+    return fprintf(stderr,
+                   "error: %s is %f, not %f\n",
+                   name,
+                   (double)value,
+                   (double)expected);
+  }
+
+  return 0;
+}
+
+int
+main(void)
+{
+  JalvModulators* const modulators = jalv_modulators_new(3U, 1000.0f);
+  float                 values[2]  = {0.0f, 0.0f};
+  int                   st         = 0;
+
+  // A 1 Hz square wave over the range from 10 to 20, with full depth
+  const JalvModSettings lfo = {.type   = JALV_MOD_LFO,
+                               .shape  = JALV_LFO_SQUARE,
+                               .target = 0U,
+                               .time   = 1.0f,
+                               .depth  = 0.5f,
+                               .offset = 0.5f,
+                               .min    = 10.0f,
+                               .max    = 20.0f};
+
+  // A 1 second ramp over the range from 0 to 1, from a quarter to the end
+  const JalvModSettings ramp = {.type   = JALV_MOD_RAMP,
+                                .target = 1U,
+                                .time   = 1.0f,
+                                .depth  = 0.75f,
+                                .offset = 0.25f,
+                                .min    = 0.0f,
+                                .max    = 1.0f};
+
+  st |= jalv_modulators_set(modulators, &lfo, &values[0]);
+  st |= jalv_modulators_set(modulators, &ramp, &values[1]);
+  st |= check("Unapplied", values[0], 0.0f);
+
+  // Modulators are evaluated at the start of each 100 ms cycle
+  jalv_modulators_run(modulators, 100U);
+  st |= check("LFO", values[0], 20.0f);
+  st |= check("Ramp", values[1], 0.25f);
+  for (uint32_t i = 0U; i < 6U; ++i) {
+    jalv_modulators_run(modulators, 100U);
+  }
+
+  st |= check("LFO", values[0], 10.0f);
+  st |= check("Ramp", values[1], 0.7f);
+  for (uint32_t i = 0U; i < 10U; ++i) {
+    jalv_modulators_run(modulators, 100U);
+  }
+
+  st |= check("Ramp", values[1], 1.0f);
+
+  // Replacing the LFO with an envelope of a full-scale input rises to the top
+  float                 input[100];
+  const JalvModSettings env = {.type    = JALV_MOD_ENVELOPE,
+                               .target  = 0U,
+                               .source  = 2U,
+                               .time    = 0.01f,
+                               .release = 0.1f,
+                               .depth   = 1.0f,
+                               .min     = 0.0f,
+                               .max     = 1.0f};
+
+  for (uint32_t i = 0U; i < 100U; ++i) {
+    input[i] = (i % 2U) ? 1.0f : -1.0f;
+  }
+
+  st |= jalv_modulators_set(modulators, &env, &values[0]);
+  jalv_modulators_connect(modulators, 2U, input);
+  jalv_modulators_run(modulators, 100U);
+  st |= check("Envelope", values[0], 1.0f - expf(-10.0f));
+
+  // A host input reduced to its peak and smoothed by a 100 ms time constant
+  const JalvModSettings map = {.type      = JALV_MOD_INPUT,
+                               .reduction = JALV_REDUCE_PEAK,
+                               .target    = 1U,
+                               .time      = 0.1f,
+                               .depth     = 1.0f,
+                               .min       = 0.0f,
+                               .max       = 2.0f};
+
+  st |= jalv_modulators_set(modulators, &map, &values[1]);
+  jalv_modulators_read_input(modulators, 1U, input, 100U);
+  jalv_modulators_run(modulators, 100U);
+  st |= check("Input", values[1], 2.0f * (1.0f - expf(-1.0f)));
+
+  // Clearing a modulator leaves its target alone
+  st |= !jalv_modulators_clear(modulators, 0U);
+  values[0] = 0.5f;
+  jalv_modulators_run(modulators, 100U);
+  st |= check("Cleared", values[0], 0.5f);
+  st |= jalv_modulators_get(modulators, 0U) != NULL;
+  st |= jalv_modulators_get(modulators, 1U) == NULL;
+
+  jalv_modulators_free(modulators);
+  return st;
+}
+
+#endif // MODULATOR_STANDALONE
@@ -0,0 +1,133 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+/**
+   @file modulator.h Host modulators that drive plugin control ports.
+
+   Modulators are evaluated in the process thread once per cycle, before the
+   plugin runs, and write directly to the value of their target control port.
+   The modulation signal is mapped to the range of the port with a depth and
+   offset, which are both fractions of that range.
+*/
+
+#ifndef JALV_MODULATOR_H
+#define JALV_MODULATOR_H
+
+#include "attributes.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+JALV_BEGIN_DECLS
+
+/// Maximum number of modulators that can be active at once
+#define JALV_MAX_MODULATORS 16U
+
+/// Type of modulation source
+typedef enum {
+  JALV_MOD_LFO,      ///< Periodic oscillator from -1 to 1
+  JALV_MOD_RAMP,     ///< Linear ramp from 0 to 1, which then holds
+  JALV_MOD_ENVELOPE, ///< Envelope follower of an audio input from 0 to 1
+  JALV_MOD_INPUT,    ///< Host audio input of the target port, as is
+} JalvModType;
+
+/// Reduction of a cycle of host input to one value
+typedef enum {
+  JALV_REDUCE_MEAN, ///< Mean sample value
+  JALV_REDUCE_PEAK, ///< Peak absolute sample value
+  JALV_REDUCE_LAST, ///< Last sample value
+} JalvReduction;
+
+/// Waveform of an LFO
+typedef enum {
+  JALV_LFO_SINE,     ///< Sine
+  JALV_LFO_TRIANGLE, ///< Triangle
+  JALV_LFO_SAW,      ///< Rising sawtooth
+  JALV_LFO_SQUARE,   ///< Square
+} JalvLfoShape;
+
+/// Settings for a modulator
+typedef struct {
+  JalvModType   type;      ///< Type of modulation source
+  JalvLfoShape  shape;     ///< Waveform, for LFOs
+  JalvReduction reduction; ///< Reduction of each cycle, for inputs
+  uint32_t      target;    ///< Index of the control port to modulate
+  uint32_t      source;    ///< Index of the audio input, for envelopes
+  float         time;      ///< LFO rate in Hz, or ramp, attack, or smoothing
+  float         release;   ///< Release time in seconds, for envelopes
+  float         depth;     ///< Amount of modulation, as a fraction of range
+  float         offset;    ///< Value without modulation, as a fraction
+  float         min;       ///< Minimum value of the target port
+  float         max;       ///< Maximum value of the target port
+} JalvModSettings;
+
+typedef struct JalvModulatorsImpl JalvModulators;
+
+/// Create a set of modulators for a plugin with `n_ports` ports
+JalvModulators*
+jalv_modulators_new(uint32_t n_ports, float sample_rate);
+
+/// Free a set of modulators
+void
+jalv_modulators_free(JalvModulators* modulators);
+
+/**
+   Set the modulator for a control port, replacing any existing one.
+
+   This is called by the UI thread.  The change is queued for the process
+   thread, which applies it at the start of the next cycle, so a modulator is
+   never changed while it runs.  The modulator starts from the beginning of
+   its period or ramp.
+
+   @param modulators The modulators.
+   @param settings Modulator settings.
+   @param target Value of the target control port, written by the modulator.
+   @return Zero on success, or non-zero if too many modulators are active or
+   too many changes are queued.
+*/
+int
+jalv_modulators_set(JalvModulators*        modulators,
+                    const JalvModSettings* settings,
+                    float*                 target);
+
+/**
+   Remove the modulator for a control port, and return true if it existed.
+
+   Like jalv_modulators_set(), this is queued for the next cycle.
+*/
+bool
+jalv_modulators_clear(JalvModulators* modulators, uint32_t target);
+
+/**
+   Return the settings of a modulator, or null if the slot is unused.
+
+   This must be called by the same thread as jalv_modulators_set().
+*/
+const JalvModSettings*
+jalv_modulators_get(const JalvModulators* modulators, uint32_t slot);
+
+/// Note the buffer connected to a plugin port (realtime safe)
+void
+jalv_modulators_connect(JalvModulators* modulators,
+                        uint32_t        port_index,
+                        const void*     buf);
+
+/**
+   Read a cycle of the host audio input for a control port (realtime safe).
+
+   This is called by the backend before running, for control ports that have
+   their own audio input, which modulators of type JALV_MOD_INPUT follow.
+*/
+void
+jalv_modulators_read_input(JalvModulators* modulators,
+                           uint32_t        port_index,
+                           const float*    buf,
+                           uint32_t        n_frames);
+
+/// Run all modulators for a cycle and update their targets (realtime safe)
+void
+jalv_modulators_run(JalvModulators* modulators, uint32_t n_frames);
+
+JALV_END_DECLS
+
+#endif // JALV_MODULATOR_H
@@ -24,6 +24,7 @@ typedef struct {
   LilvNode* lv2_connectionOptional;
   LilvNode* lv2_control;
   LilvNode* lv2_default;
+  LilvNode* lv2_enabled;
   LilvNode* lv2_enumeration;
   LilvNode* lv2_extensionData;
   LilvNode* lv2_integer;
@@ -45,6 +46,10 @@ typedef struct {
   LilvNode* rdfs_label;
   LilvNode* rdfs_range;
   LilvNode* rsz_minimumSize;
+  LilvNode* ui_notifyType;
+  LilvNode* ui_plugin;
+  LilvNode* ui_portIndex;
+  LilvNode* ui_portNotification;
   LilvNode* ui_showInterface;
   LilvNode* work_interface;
   LilvNode* work_schedule;
@@ -29,6 +29,22 @@ typedef struct {
   int      print_controls;  ///< Print control changes to stdout
   int      non_interactive; ///< Do not listen for commands on stdin
   char*    ui_uri;          ///< URI of UI to load
+  int      pipelined;       ///< Run plugin in a DSP thread one period behind
+  int      dsp_cpu;         ///< CPU to pin the DSP thread to, or -1
+  int      generic_process; ///< Always use the generic process callback
+  char**   hidden_ports;    ///< Symbol patterns of ports not to register
+  int      hide_optional;   ///< Do not register connectionOptional ports
+  char**   input_buses;     ///< Mixed inputs like "SYMBOL=N"
+  int      oversample;      ///< Oversampling factor (2 or 4), or 0
+  int      output_stage;    ///< Add host dry/wet and output gain controls
+  int      bypass_idle;     ///< Do not run plugin while bypassed
+  double   meter_rate;      ///< Audio level meter rate in Hz, or 0
+  int      loudness;        ///< Measure short-term loudness when metering
+  char**   scope_taps;      ///< Capture taps like "SYMBOL=LENGTH:DECIMATION"
+  char*    watchdog;        ///< Overrun watchdog like "FRACTION:CYCLES:SECONDS"
+  char**   control_inputs;  ///< Symbols of controls with their own audio input
+  char**   aggregates;      ///< Output reductions like "SYMBOL=max"
+  char**   port_rates;      ///< UI update rates like "SYMBOL=HZ"
 } JalvOptions;
 
 JALV_END_DECLS
@@ -0,0 +1,280 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+#include "oversampler.h"
+
+#include "dsp.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+  The anti-imaging and anti-aliasing filter is a Blackman-windowed sinc with
+  TAPS_PER_LOW_FRAME * factor + 1 taps, so it is symmetric with an integer
+  group delay of TAPS_PER_LOW_FRAME / 2 low rate frames.  Upsampling uses the
+  polyphase decomposition, so each output frame only reads one phase of the
+  filter.  Coefficients are stored reversed, so every output frame is a
+  single contiguous dot product with the history buffer.
+*/
+
+#define TAPS_PER_LOW_FRAME 16U
+
+struct JalvOversamplerImpl {
+  uint32_t factor;     ///< Oversampling factor
+  uint32_t max_frames; ///< Maximum number of low rate frames per call
+  uint32_t n_taps;     ///< Length of the prototype filter
+  uint32_t n_phase;    ///< Length of each polyphase filter
+  float*   taps;       ///< Prototype filter (symmetric, so also reversed)
+  float*   phases;     ///< Reversed polyphase filters scaled by factor
+  float*   history;    ///< Previous input followed by current input
+};
+
+#ifndef M_PI
+#  define M_PI 3.14159265358979323846
+#endif
+
+/// Design a low-pass filter with a cutoff just below the low rate Nyquist
+static void
+design_filter(float* const taps, const uint32_t n_taps, const uint32_t factor)
+{
+  const double fc     = 0.45 / (double)factor;
+  const double center = (double)(n_taps - 1U) / 2.0;
+  double       sum    = 0.0;
+
+  for (uint32_t i = 0U; i < n_taps; ++i) {
+    const double x    = (double)i - center;
+    const double sinc =
+      x == 0.0 ? 2.0 * fc : sin(2.0 * M_PI * fc * x) / (M_PI * x);
+    const double w    = 0.42 - 0.5 * cos(2.0 * M_PI * i / (n_taps - 1U)) +
+                     0.08 * cos(4.0 * M_PI * i / (n_taps - 1U));
+
+    taps[i] = (float)(sinc * w);
+    sum += (double)taps[i];
+  }
+
+  // Normalise to unity gain at DC
+  for (uint32_t i = 0U; i < n_taps; ++i) {
+    taps[i] = (float)((double)taps[i] / sum);
+  }
+}
+
+JalvOversampler*
+jalv_oversampler_new(const uint32_t factor, const uint32_t max_frames)
+{
+  if (factor != 2U && factor != 4U) {
+    return NULL;
+  }
+
+  JalvOversampler* const os =
+    (JalvOversampler*)calloc(1, sizeof(JalvOversampler));
+  if (!os) {
+    return NULL;
+  }
+
+  os->factor     = factor;
+  os->max_frames = max_frames;
+  os->n_taps     = TAPS_PER_LOW_FRAME * factor + 1U;
+  os->n_phase    = (os->n_taps + factor - 1U) / factor;
+  os->taps       = (float*)calloc(os->n_taps, sizeof(float));
+  os->phases     = (float*)calloc(os->n_phase * factor, sizeof(float));
+
+  // History is large enough for downsampling, which needs more
+  os->history = jalv_dsp_alloc(os->n_taps - 1U + max_frames * factor);
+
+  if (!os->taps || !os->phases || !os->history) {
+    jalv_oversampler_free(os);
+    return NULL;
+  }
+
+  design_filter(os->taps, os->n_taps, factor);
+
+  // Split into reversed phases, padded with zeros to a whole number of taps
+  for (uint32_t j = 0U; j < factor; ++j) {
+    float* const phase = os->phases + j * os->n_phase;
+    for (uint32_t i = 0U; i < os->n_phase; ++i) {
+      const uint32_t t = (os->n_phase - 1U - i) * factor + j;
+      phase[i]         = t < os->n_taps ? os->taps[t] * (float)factor : 0.0f;
+    }
+  }
+
+  return os;
+}
+
+void
+jalv_oversampler_free(JalvOversampler* const os)
+{
+  if (os) {
+    free(os->taps);
+    free(os->phases);
+    jalv_dsp_free(os->history);
+    free(os);
+  }
+}
+
+uint32_t
+jalv_oversampler_latency(const uint32_t factor)
+{
+  (void)factor;
+  return TAPS_PER_LOW_FRAME;
+}
+
+void
+jalv_oversampler_up(JalvOversampler* const os,
+                    const float* const     in,
+                    float* const           out,
+                    const uint32_t         n_frames)
+{
+  const uint32_t n_history = os->n_phase - 1U;
+  float* const   history   = os->history;
+
+  memcpy(history + n_history, in, n_frames * sizeof(float));
+
+  for (uint32_t n = 0U; n < n_frames; ++n) {
+    for (uint32_t j = 0U; j < os->factor; ++j) {
+      out[n * os->factor + j] = jalv_dsp_dot(
+        os->phases + j * os->n_phase, history + n, os->n_phase);
+    }
+  }
+
+  memmove(history, history + n_frames, n_history * sizeof(float));
+}
+
+void
+jalv_oversampler_down(JalvOversampler* const os,
+                      const float* const     in,
+                      float* const           out,
+                      const uint32_t         n_frames)
+{
+  const uint32_t n_history = os->n_taps - 1U;
+  const uint32_t n_in      = n_frames * os->factor;
+  float* const   history   = os->history;
+
+  memcpy(history + n_history, in, n_in * sizeof(float));
+
+  for (uint32_t n = 0U; n < n_frames; ++n) {
+    out[n] = jalv_dsp_dot(os->taps, history + n * os->factor, os->n_taps);
+  }
+
+  memmove(history, history + n_in, n_history * sizeof(float));
+}
+
+#ifdef OVERSAMPLER_STANDALONE
+
+#  include <stdio.h>
+
+#  define TEST_BLOCK 64U                         ///< Low rate frames per call
+#  define TEST_BLOCKS 32U                        ///< Number of calls
+#  define TEST_FRAMES (TEST_BLOCK * TEST_BLOCKS) ///< Total low rate frames
+
+/// Return the amplitude of a frequency in cycles per frame, from `start` on
+static double
+amplitude(const float* const buf,
+          const uint32_t     start,
+          const uint32_t     end,
+          const double       freq)
+{
+  double re = 0.0;
+  double im = 0.0;
+  for (uint32_t i = start; i < end; ++i) {
+    re += (double)buf[i] * cos(2.0 * M_PI * freq * i);
+    im += (double)buf[i] * sin(2.0 * M_PI * freq * i);
+  }
+
+  return 2.0 * sqrt(re * re + im * im) / (double)(end - start);
+}
+
+/// Upsample then downsample `in` in blocks, and store each stage
+static int
+run(const uint32_t     factor,
+    const float* const in,
+    float* const       high,
+    float* const       out)
+{
+  JalvOversampler* const up   = jalv_oversampler_new(factor, TEST_BLOCK);
+  JalvOversampler* const down = jalv_oversampler_new(factor, TEST_BLOCK);
+  if (!up || !down) {
+    jalv_oversampler_free(up);
+    jalv_oversampler_free(down);
+    return 1;
+  }
+
+  for (uint32_t b = 0U; b < TEST_BLOCKS; ++b) {
+    float* const block_high = high + b * TEST_BLOCK * factor;
+    jalv_oversampler_up(up, in + b * TEST_BLOCK, block_high, TEST_BLOCK);
+    jalv_oversampler_down(down, block_high, out + b * TEST_BLOCK, TEST_BLOCK);
+  }
+
+  jalv_oversampler_free(up);
+  jalv_oversampler_free(down);
+  return 0;
+}
+
+static int
+test_factor(const uint32_t factor)
+{
+  static float in[TEST_FRAMES];
+  static float high[TEST_FRAMES * 4U];
+  static float out[TEST_FRAMES];
+
+  const uint32_t latency = jalv_oversampler_latency(factor);
+  const uint32_t settled = 4U * latency; // Skip the start of the response
+  const double   freq    = 0.1;          // Well within the passband
+  int            st      = 0;
+
+  // A sine passes through with unity gain
+  for (uint32_t i = 0U; i < TEST_FRAMES; ++i) {
+    in[i] = (float)sin(2.0 * M_PI * freq * i);
+  }
+
+  st |= run(factor, in, high, out);
+
+  const double gain = amplitude(out, settled, TEST_FRAMES, freq);
+  if (fabs(gain - 1.0) > 0.01) {
+    st |= fprintf(stderr, "error: x%u passband gain is %f\n", factor, gain);
+  }
+
+  // Images of the sine at the high rate are rejected
+  const uint32_t n_high = TEST_FRAMES * factor;
+  const double   signal =
+    amplitude(high, settled * factor, n_high, freq / factor);
+  for (uint32_t k = 1U; k < factor; ++k) {
+    const double image_freq = (k - freq) / factor;
+    const double image =
+      amplitude(high, settled * factor, n_high, image_freq);
+    const double rejection = 20.0 * log10(image / signal);
+    if (rejection > -60.0) {
+      st |= fprintf(
+        stderr, "error: x%u image rejection is %f dB\n", factor, rejection);
+    }
+  }
+
+  // The delay of an impulse through both filters is the reported latency
+  memset(in, 0, sizeof(in));
+  in[TEST_BLOCK / 2U] = 1.0f;
+  st |= run(factor, in, high, out);
+
+  uint32_t peak = 0U;
+  for (uint32_t i = 1U; i < TEST_FRAMES; ++i) {
+    peak = fabsf(out[i]) > fabsf(out[peak]) ? i : peak;
+  }
+
+  if (peak - TEST_BLOCK / 2U != latency) {
+    st |= fprintf(stderr,
+                  "error: x%u delay is %u, not %u\n",
+                  factor,
+                  peak - TEST_BLOCK / 2U,
+                  latency);
+  }
+
+  return st;
+}
+
+int
+main(void)
+{
+  return test_factor(2U) | test_factor(4U);
+}
+
+#endif // OVERSAMPLER_STANDALONE
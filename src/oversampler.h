@@ -0,0 +1,64 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+/**
+   @file oversampler.h Integer-factor resampling for running plugins at a
+   multiple of the audio system sample rate.
+*/
+
+#ifndef JALV_OVERSAMPLER_H
+#define JALV_OVERSAMPLER_H
+
+#include "attributes.h"
+
+#include <stdint.h>
+
+JALV_BEGIN_DECLS
+
+/**
+   Polyphase FIR resampler for one channel.
+
+   A resampler keeps the history of the signal it processes, so each instance
+   must only be used to either upsample or downsample a single channel.
+*/
+typedef struct JalvOversamplerImpl JalvOversampler;
+
+/**
+   Create a new resampler.
+
+   @param factor Oversampling factor, 2 or 4.
+   @param max_frames Maximum number of frames at the low rate per call.
+   @return A new resampler, or null on error.
+*/
+JalvOversampler*
+jalv_oversampler_new(uint32_t factor, uint32_t max_frames);
+
+/// Free a resampler
+void
+jalv_oversampler_free(JalvOversampler* os);
+
+/**
+   Return the total latency of upsampling and then downsampling.
+
+   This is in frames at the low rate, and is always an integer.
+*/
+uint32_t
+jalv_oversampler_latency(uint32_t factor);
+
+/// Upsample `n_frames` of `in` to `n_frames * factor` frames in `out`
+void
+jalv_oversampler_up(JalvOversampler* os,
+                    const float*     in,
+                    float*           out,
+                    uint32_t         n_frames);
+
+/// Downsample `n_frames * factor` frames of `in` to `n_frames` in `out`
+void
+jalv_oversampler_down(JalvOversampler* os,
+                      const float*     in,
+                      float*           out,
+                      uint32_t         n_frames);
+
+JALV_END_DECLS
+
+#endif // JALV_OVERSAMPLER_H
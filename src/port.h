@@ -18,6 +18,9 @@ enum PortFlow { FLOW_UNKNOWN, FLOW_INPUT, FLOW_OUTPUT };
 
 enum PortType { TYPE_UNKNOWN, TYPE_CONTROL, TYPE_AUDIO, TYPE_EVENT, TYPE_CV };
 
+/// Reduction of output control values between UI updates
+enum PortAggregate { AGGREGATE_LAST, AGGREGATE_MAX, AGGREGATE_MIN };
+
 struct Port {
   const LilvPort* lilv_port; ///< LV2 port
   enum PortType   type;      ///< Data type
@@ -26,8 +29,16 @@ struct Port {
   LV2_Evbuf*      evbuf;     ///< For MIDI ports, otherwise NULL
   void*           widget;    ///< Control widget, if applicable
   size_t          buf_size;  ///< Custom buffer size, or 0
+  uint32_t*       notify;    ///< Event types sent to the UI, or null
   uint32_t        index;     ///< Port index
   float           control;   ///< For control ports, otherwise 0.0f
+  float           epsilon;   ///< Smallest output change sent to the UI
+  float           sent;      ///< Last output value sent to the UI, or NaN
+  float           peak;      ///< Output reduced since the last update, or NaN
+  int             aggregate; ///< Reduction of outputs (enum PortAggregate)
+  float           rate;      ///< UI update rate in Hz, or 0 for the default
+  uint32_t        period;    ///< Frames between UI updates, or 0
+  uint32_t        due;       ///< Frames until the next UI update
 };
 
 JALV_END_DECLS
@@ -33,11 +33,9 @@ pa_process_cb(const void*                     inputs,
     struct Port* port = &jalv->ports[i];
     if (port->type == TYPE_AUDIO) {
       if (port->flow == FLOW_INPUT) {
-        lilv_instance_connect_port(
-          jalv->instance, i, ((float**)inputs)[in_index++]);
+        jalv_connect_audio_port(jalv, i, ((float**)inputs)[in_index++]);
       } else if (port->flow == FLOW_OUTPUT) {
-        lilv_instance_connect_port(
-          jalv->instance, i, ((float**)outputs)[out_index++]);
+        jalv_connect_audio_port(jalv, i, ((float**)outputs)[out_index++]);
       }
     } else if (port->type == TYPE_EVENT && port->flow == FLOW_INPUT) {
       lv2_evbuf_reset(port->evbuf, true);
@@ -65,22 +63,11 @@ pa_process_cb(const void*                     inputs,
   for (uint32_t p = 0; p < jalv->num_ports; ++p) {
     struct Port* const port = &jalv->ports[p];
     if (port->flow == FLOW_OUTPUT && port->type == TYPE_EVENT) {
-      for (LV2_Evbuf_Iterator i = lv2_evbuf_begin(port->evbuf);
-           lv2_evbuf_is_valid(i);
-           i = lv2_evbuf_next(i)) {
-        // Get event from LV2 buffer
-        uint32_t frames, subframes, type, size;
-        void*    body;
-        lv2_evbuf_get(i, &frames, &subframes, &type, &size, &body);
-
-        if (jalv->has_ui) {
-          // Forward event to UI
-          jalv_write_event(jalv, jalv->plugin_to_ui, p, size, type, body);
-        }
-      }
+      // Forward all events to UI in a single message
+      jalv_write_events(jalv, p, port->evbuf);
     } else if (send_ui_updates && port->flow == FLOW_OUTPUT &&
                port->type == TYPE_CONTROL) {
-      jalv_write_control(jalv, jalv->plugin_to_ui, p, port->control);
+      jalv_send_control_output(jalv, p);
     }
   }
 
@@ -175,6 +162,14 @@ jalv_backend_close(Jalv* jalv)
 void
 jalv_backend_activate(Jalv* jalv)
 {
+  if (jalv->opts.pipelined) {
+    jalv_log(JALV_LOG_WARNING, "Pipelined execution is not supported\n");
+  }
+
+  if (jalv->opts.oversample) {
+    jalv_log(JALV_LOG_WARNING, "Oversampling is not supported\n");
+  }
+
   const int st = Pa_StartStream(jalv->backend->stream);
   if (st != paNoError) {
     jalv_log(
@@ -204,3 +199,31 @@ jalv_backend_activate_port(Jalv* jalv, uint32_t port_index)
     break;
   }
 }
+
+int
+jalv_backend_set_input_gain(Jalv*    jalv,
+                            uint32_t port_index,
+                            uint32_t source,
+                            float    gain)
+{
+  (void)jalv;
+  (void)port_index;
+  (void)source;
+  (void)gain;
+  return 1;
+}
+
+bool
+jalv_backend_has_control_input(Jalv* jalv, uint32_t port_index)
+{
+  (void)jalv;
+  (void)port_index;
+  return false;
+}
+
+void
+jalv_backend_print_stats(Jalv* jalv, FILE* stream)
+{
+  (void)jalv;
+  fprintf(stream, "Pipelined:    no\n");
+}
@@ -0,0 +1,250 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+#include "ring.h"
+
+#include "atomic.h"
+
+#include "zix/ring.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+struct JalvRingImpl {
+  ZixRing* current;    ///< Ring used by the producer and consumer (atomic)
+  ZixRing* pending;    ///< New ring to switch to, or null (atomic)
+  ZixRing* retired;    ///< Old ring to free once unused, or null (atomic)
+  ZixRing* reader;     ///< Ring the consumer is reading, or null (atomic)
+  int      high_water; ///< Most bytes used at once (atomic)
+  int      n_dropped;  ///< Number of dropped messages (atomic)
+  int      n_resizes;  ///< Number of switches to a new ring (atomic)
+};
+
+/// Allocate a new locked ZixRing
+static ZixRing*
+jalv_ring_alloc(const uint32_t size)
+{
+  ZixRing* const zring = zix_ring_new(NULL, size);
+  if (zring) {
+    zix_ring_mlock(zring);
+  }
+
+  return zring;
+}
+
+JalvRing*
+jalv_ring_new(const uint32_t size)
+{
+  JalvRing* const ring = (JalvRing*)calloc(1, sizeof(JalvRing));
+  if (ring && !(ring->current = jalv_ring_alloc(size))) {
+    free(ring);
+    return NULL;
+  }
+
+  return ring;
+}
+
+void
+jalv_ring_free(JalvRing* const ring)
+{
+  if (ring) {
+    zix_ring_free(ring->current);
+    zix_ring_free(ring->pending);
+    zix_ring_free(ring->retired);
+    free(ring);
+  }
+}
+
+/// Return the ring to write to, switching to a pending one if possible
+static ZixRing*
+jalv_ring_writer(JalvRing* const ring)
+{
+  ZixRing* const current = (ZixRing*)JALV_ATOMIC_LOAD_PTR(&ring->current);
+  ZixRing* const pending = (ZixRing*)JALV_ATOMIC_LOAD_PTR(&ring->pending);
+
+  // Only switch once drained, so nothing is read out of order
+  if (!pending || zix_ring_read_space(current)) {
+    return current;
+  }
+
+  // Retire the old ring after switching, so it's never freed while current
+  JALV_ATOMIC_STORE_PTR(&ring->current, pending);
+  JALV_ATOMIC_STORE_PTR(&ring->pending, NULL);
+  JALV_ATOMIC_STORE_PTR(&ring->retired, current);
+  JALV_ATOMIC_ADD(&ring->n_resizes, 1);
+  return pending;
+}
+
+int
+jalv_ring_write(JalvRing* const   ring,
+                const void* const header,
+                const uint32_t    header_size,
+                const void* const body,
+                const uint32_t    body_size)
+{
+  ZixRing* const     zring = jalv_ring_writer(ring);
+  ZixRingTransaction tx    = zix_ring_begin_write(zring);
+  if (zix_ring_amend_write(zring, &tx, header, header_size) ||
+      zix_ring_amend_write(zring, &tx, body, body_size)) {
+    JALV_ATOMIC_ADD(&ring->n_dropped, 1);
+    return 1;
+  }
+
+  zix_ring_commit_write(zring, &tx);
+
+  // Only the producer writes the high-water mark, so this doesn't race
+  const int used = (int)zix_ring_read_space(zring);
+  if (used > JALV_ATOMIC_LOAD(&ring->high_water)) {
+    JALV_ATOMIC_STORE(&ring->high_water, used);
+  }
+
+  return 0;
+}
+
+ZixRing*
+jalv_ring_begin_read(JalvRing* const ring)
+{
+  // Publish the ring being read, and retry if the producer just switched
+  ZixRing* zring = NULL;
+  do {
+    zring = (ZixRing*)JALV_ATOMIC_LOAD_PTR(&ring->current);
+    JALV_ATOMIC_STORE_PTR(&ring->reader, zring);
+    JALV_FENCE();
+  } while (zring != (ZixRing*)JALV_ATOMIC_LOAD_PTR(&ring->current));
+
+  return zring;
+}
+
+void
+jalv_ring_end_read(JalvRing* const ring)
+{
+  JALV_ATOMIC_STORE_PTR(&ring->reader, NULL);
+}
+
+/// Free the retired ring if the consumer isn't reading it
+static void
+jalv_ring_reclaim(JalvRing* const ring)
+{
+  ZixRing* const retired = (ZixRing*)JALV_ATOMIC_LOAD_PTR(&ring->retired);
+
+  JALV_FENCE();
+  if (retired && JALV_ATOMIC_LOAD_PTR(&ring->reader) != retired) {
+    JALV_ATOMIC_STORE_PTR(&ring->retired, NULL);
+    zix_ring_free(retired);
+  }
+}
+
+int
+jalv_ring_resize(JalvRing* const ring, const uint32_t size)
+{
+  jalv_ring_reclaim(ring);
+  if (JALV_ATOMIC_LOAD_PTR(&ring->pending) ||
+      JALV_ATOMIC_LOAD_PTR(&ring->retired)) {
+    return 1;
+  }
+
+  ZixRing* const zring = jalv_ring_alloc(size);
+  if (!zring) {
+    return 1;
+  }
+
+  JALV_ATOMIC_STORE_PTR(&ring->pending, zring);
+  return 0;
+}
+
+void
+jalv_ring_stats(const JalvRing* const ring, JalvRingStats* const stats)
+{
+  const ZixRing* const current =
+    (const ZixRing*)JALV_ATOMIC_LOAD_PTR(&ring->current);
+
+  stats->capacity   = zix_ring_capacity(current);
+  stats->high_water = (uint32_t)JALV_ATOMIC_LOAD(&ring->high_water);
+  stats->n_dropped  = (uint32_t)JALV_ATOMIC_LOAD(&ring->n_dropped);
+  stats->n_resizes  = (uint32_t)JALV_ATOMIC_LOAD(&ring->n_resizes);
+}
+
+#ifdef RING_STANDALONE
+
+#  include <stdio.h>
+
+/// Write a message of `size` bytes that start with `id`
+static int
+write_message(JalvRing* const ring, const uint32_t id, const uint32_t size)
+{
+  const uint8_t  body[64]  = {0U};
+  const uint32_t body_size = size - (uint32_t)sizeof(id);
+
+  return jalv_ring_write(ring, &id, sizeof(id), body, body_size);
+}
+
+/// Read a message of `size` bytes and return its id, or UINT32_MAX
+static uint32_t
+read_message(JalvRing* const ring, const uint32_t size)
+{
+  ZixRing* const zring     = jalv_ring_begin_read(ring);
+  const uint32_t body_size = size - (uint32_t)sizeof(uint32_t);
+  uint8_t        body[64];
+  uint32_t       id = UINT32_MAX;
+  if (zix_ring_read(zring, &id, sizeof(id)) != sizeof(id) ||
+      zix_ring_read(zring, body, body_size) != body_size) {
+    id = UINT32_MAX;
+  }
+
+  jalv_ring_end_read(ring);
+  return id;
+}
+
+int
+main(void)
+{
+  JalvRing* const ring = jalv_ring_new(64U);
+  JalvRingStats   stats;
+  int             st = 0;
+
+  // Fill the ring with 16 byte messages until one is dropped
+  uint32_t n_written = 0U;
+  while (!write_message(ring, n_written, 16U)) {
+    ++n_written;
+  }
+
+  jalv_ring_stats(ring, &stats);
+  st |= stats.n_dropped != 1U || stats.high_water != n_written * 16U;
+
+  // Resize while messages are queued, and keep writing to the old ring
+  st |= jalv_ring_resize(ring, 256U);
+  st |= !jalv_ring_resize(ring, 512U);
+  st |= read_message(ring, 16U) != 0U;
+  st |= write_message(ring, n_written++, 16U);
+
+  // The producer only switches once the old ring has been drained
+  uint32_t n_read = 1U;
+  while (n_read < n_written) {
+    st |= read_message(ring, 16U) != n_read++;
+  }
+
+  jalv_ring_stats(ring, &stats);
+  st |= stats.n_resizes != 0U || stats.capacity >= 256U;
+  for (uint32_t i = 0U; i < 8U; ++i) {
+    st |= write_message(ring, n_written++, 16U);
+  }
+
+  jalv_ring_stats(ring, &stats);
+  st |= stats.n_resizes != 1U || stats.capacity < 255U;
+  st |= stats.high_water != 128U || stats.n_dropped != 1U;
+  while (n_read < n_written) {
+    st |= read_message(ring, 16U) != n_read++;
+  }
+
+  // The old ring is reclaimed by the next resize
+  st |= jalv_ring_resize(ring, 64U);
+
+  jalv_ring_free(ring);
+  if (st) {
+    fprintf(stderr, "error: Unexpected ring state\n");
+  }
+
+  return st;
+}
+
+#endif // RING_STANDALONE
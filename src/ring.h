@@ -0,0 +1,95 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+/**
+   @file ring.h A message ring between threads that can be resized online.
+
+   This wraps a ZixRing with a single producer and a single consumer, and
+   keeps statistics about how full it gets and how many messages are dropped.
+
+   To resize, a new ring is allocated off-thread and left pending.  The
+   producer switches to it on the first write after the old ring has been
+   drained, so messages stay in order.  The old ring is then retired, and
+   freed off-thread once the consumer is no longer reading it.  Neither the
+   producer nor the consumer ever blocks or allocates.
+*/
+
+#ifndef JALV_RING_H
+#define JALV_RING_H
+
+#include "attributes.h"
+
+#include "zix/ring.h"
+
+#include <stdint.h>
+
+JALV_BEGIN_DECLS
+
+/// Usage statistics of a ring
+typedef struct {
+  uint32_t capacity;   ///< Size of the current ring in bytes
+  uint32_t high_water; ///< Most bytes used at once
+  uint32_t n_dropped;  ///< Number of messages dropped because it was full
+  uint32_t n_resizes;  ///< Number of times the producer switched rings
+} JalvRingStats;
+
+typedef struct JalvRingImpl JalvRing;
+
+/// Create a new locked ring of at least `size` bytes
+JalvRing*
+jalv_ring_new(uint32_t size);
+
+/// Free a ring, which must no longer be used by any thread
+void
+jalv_ring_free(JalvRing* ring);
+
+/**
+   Write a message to the ring in a single transaction (realtime safe).
+
+   Only the producer may call this.
+
+   @return Zero on success, or non-zero if the ring is full.
+*/
+int
+jalv_ring_write(JalvRing*   ring,
+                const void* header,
+                uint32_t    header_size,
+                const void* body,
+                uint32_t    body_size);
+
+/**
+   Begin reading from the ring (realtime safe).
+
+   Only the consumer may call this, and must call jalv_ring_end_read() when
+   finished with the returned ring.
+
+   @return The ZixRing to read messages from.
+*/
+ZixRing*
+jalv_ring_begin_read(JalvRing* ring);
+
+/// Finish reading from the ring (realtime safe)
+void
+jalv_ring_end_read(JalvRing* ring);
+
+/**
+   Request that the ring is resized.
+
+   This may be called from any thread, but not concurrently with itself.  The
+   producer and consumer continue to run as usual, and the producer switches
+   to the new ring once everything in the old one has been read.  The old ring
+   is freed by the next resize once the consumer has finished with it, or when
+   the ring is freed.
+
+   @return Zero on success, or non-zero if a previous resize hasn't finished.
+*/
+int
+jalv_ring_resize(JalvRing* ring, uint32_t size);
+
+/// Get the current usage statistics of a ring
+void
+jalv_ring_stats(const JalvRing* ring, JalvRingStats* stats);
+
+JALV_END_DECLS
+
+#endif // JALV_RING_H
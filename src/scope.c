@@ -0,0 +1,248 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+#include "scope.h"
+
+#include "dsp.h"
+#include "triple_buffer.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  uint32_t          port;       ///< Port index
+  const float*      buf;        ///< Connected buffer, or null
+  uint32_t          length;     ///< Window length in decimated frames
+  uint32_t          decimation; ///< Input frames per captured frame
+  uint32_t          phase;      ///< Input frames until the next capture
+  float*            history;    ///< Ring of recent captured frames
+  uint32_t          head;       ///< Write position in history
+  uint32_t          n_frames;   ///< Number of valid frames in history
+  uint64_t          frame;      ///< Total number of input frames
+  JalvTripleBuffer* snapshots;  ///< Published window snapshots
+} JalvScopeTap;
+
+struct JalvScopeImpl {
+  JalvScopeTap* taps;    ///< Taps
+  uint32_t      n_taps;  ///< Number of taps
+  uint32_t      n_ports; ///< Number of plugin ports
+};
+
+JalvScope*
+jalv_scope_new(const uint32_t n_ports)
+{
+  JalvScope* const scope = (JalvScope*)calloc(1, sizeof(JalvScope));
+  if (scope) {
+    scope->n_ports = n_ports;
+  }
+
+  return scope;
+}
+
+void
+jalv_scope_free(JalvScope* const scope)
+{
+  if (scope) {
+    for (uint32_t t = 0U; t < scope->n_taps; ++t) {
+      jalv_dsp_free(scope->taps[t].history);
+      jalv_triple_buffer_free(scope->taps[t].snapshots);
+    }
+
+    free(scope->taps);
+    free(scope);
+  }
+}
+
+int
+jalv_scope_add_tap(JalvScope* const scope,
+                   const uint32_t   port_index,
+                   const uint32_t   length,
+                   const uint32_t   decimation)
+{
+  if (port_index >= scope->n_ports || !length) {
+    return 1;
+  }
+
+  JalvScopeTap* const taps = (JalvScopeTap*)realloc(
+    scope->taps, (scope->n_taps + 1U) * sizeof(JalvScopeTap));
+  if (!taps) {
+    return 1;
+  }
+
+  scope->taps = taps;
+
+  JalvScopeTap* const tap = &taps[scope->n_taps];
+  memset(tap, 0, sizeof(JalvScopeTap));
+  tap->port       = port_index;
+  tap->length     = length;
+  tap->decimation = decimation ? decimation : 1U;
+  tap->history    = jalv_dsp_alloc(length);
+  tap->snapshots  = jalv_triple_buffer_new(sizeof(JalvScopeSnapshot) +
+                                          length * sizeof(float));
+
+  if (!tap->history || !tap->snapshots) {
+    jalv_dsp_free(tap->history);
+    jalv_triple_buffer_free(tap->snapshots);
+    return 1;
+  }
+
+  ++scope->n_taps;
+  return 0;
+}
+
+uint32_t
+jalv_scope_n_taps(const JalvScope* const scope)
+{
+  return scope->n_taps;
+}
+
+uint32_t
+jalv_scope_port(const JalvScope* const scope, const uint32_t tap)
+{
+  return scope->taps[tap].port;
+}
+
+void
+jalv_scope_connect(JalvScope* const  scope,
+                   const uint32_t    port_index,
+                   const void* const buf)
+{
+  for (uint32_t t = 0U; t < scope->n_taps; ++t) {
+    if (scope->taps[t].port == port_index) {
+      scope->taps[t].buf = (const float*)buf;
+    }
+  }
+}
+
+/// Append captured frames from a cycle of input to the history of a tap
+static void
+jalv_scope_capture(JalvScopeTap* const tap, const uint32_t n_frames)
+{
+  if (tap->decimation == 1U) {
+    // Copy only the frames that fit, wrapping around the end of the ring
+    const uint32_t n   = n_frames < tap->length ? n_frames : tap->length;
+    const float*   src = tap->buf + (n_frames - n);
+    uint32_t       i   = 0U;
+    while (i < n) {
+      const uint32_t space = tap->length - tap->head;
+      const uint32_t count = n - i < space ? n - i : space;
+
+      memcpy(tap->history + tap->head, src + i, count * sizeof(float));
+      tap->head = (tap->head + count) % tap->length;
+      i += count;
+    }
+
+    tap->n_frames += n;
+  } else {
+    for (uint32_t i = tap->phase; i < n_frames; i += tap->decimation) {
+      tap->history[tap->head] = tap->buf[i];
+      tap->head               = (tap->head + 1U) % tap->length;
+      ++tap->n_frames;
+    }
+
+    // Calculate the offset of the next capture in the next cycle
+    const uint32_t past = (n_frames - tap->phase) % tap->decimation;
+    tap->phase = n_frames > tap->phase ? (past ? tap->decimation - past : 0U)
+                                       : tap->phase - n_frames;
+  }
+
+  if (tap->n_frames > tap->length) {
+    tap->n_frames = tap->length;
+  }
+}
+
+/// Publish the current window of a tap as a linear snapshot
+static void
+jalv_scope_publish(JalvScopeTap* const tap)
+{
+  JalvScopeSnapshot* const snapshot =
+    (JalvScopeSnapshot*)jalv_triple_buffer_write_begin(tap->snapshots);
+
+  const uint32_t tail = tap->length - tap->head;
+
+  snapshot->frame    = tap->frame;
+  snapshot->n_frames = tap->n_frames;
+  snapshot->length   = tap->length;
+  memcpy(snapshot->data, tap->history + tap->head, tail * sizeof(float));
+  memcpy(snapshot->data + tail, tap->history, tap->head * sizeof(float));
+
+  jalv_triple_buffer_write_end(tap->snapshots);
+}
+
+void
+jalv_scope_run(JalvScope* const scope, const uint32_t n_frames)
+{
+  for (uint32_t t = 0U; t < scope->n_taps; ++t) {
+    JalvScopeTap* const tap = &scope->taps[t];
+    if (tap->buf) {
+      jalv_scope_capture(tap, n_frames);
+      tap->frame += n_frames;
+      jalv_scope_publish(tap);
+    }
+  }
+}
+
+const JalvScopeSnapshot*
+jalv_scope_read(JalvScope* const scope, const uint32_t tap)
+{
+  return (const JalvScopeSnapshot*)jalv_triple_buffer_read(
+    scope->taps[tap].snapshots, NULL);
+}
+
+#ifdef SCOPE_STANDALONE
+
+#  include <stdio.h>
+
+#  define TEST_LENGTH 50U
+#  define TEST_BLOCK 37U
+
+static int
+test_scope(const uint32_t decimation)
+{
+  JalvScope* const scope = jalv_scope_new(1U);
+  if (!scope || jalv_scope_add_tap(scope, 0U, TEST_LENGTH, decimation)) {
+    return fprintf(stderr, "error: Failed to create scope\n");
+  }
+
+  // Capture a ramp where each frame is its own index
+  float buf[TEST_BLOCK];
+  jalv_scope_connect(scope, 0U, buf);
+
+  int st = 0;
+  for (uint32_t b = 0U; b < 20U && !st; ++b) {
+    for (uint32_t i = 0U; i < TEST_BLOCK; ++i) {
+      buf[i] = (float)(b * TEST_BLOCK + i);
+    }
+
+    jalv_scope_run(scope, TEST_BLOCK);
+
+    const JalvScopeSnapshot* const snap = jalv_scope_read(scope, 0U);
+    const uint32_t                 end  = (b + 1U) * TEST_BLOCK;
+    const uint32_t n_caps     = (end + decimation - 1U) / decimation;
+    const uint32_t expected_n = n_caps < TEST_LENGTH ? n_caps : TEST_LENGTH;
+    if (snap->frame != end || snap->n_frames != expected_n) {
+      st = fprintf(stderr, "error: Bad snapshot after %u frames\n", end);
+    }
+
+    // The newest captured frame is the last multiple of the decimation
+    for (uint32_t i = 0U; i < snap->n_frames && !st; ++i) {
+      const uint32_t age = snap->n_frames - 1U - i;
+      const float    ref = (float)((n_caps - 1U - age) * decimation);
+      if (snap->data[TEST_LENGTH - snap->n_frames + i] != ref) {
+        st = fprintf(stderr, "error: Bad frame %u after %u frames\n", i, end);
+      }
+    }
+  }
+
+  jalv_scope_free(scope);
+  return st;
+}
+
+int
+main(void)
+{
+  return test_scope(1U) || test_scope(3U) || test_scope(64U);
+}
+
+#endif // SCOPE_STANDALONE
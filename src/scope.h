@@ -0,0 +1,82 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+/**
+   @file scope.h Taps that capture recent audio from plugin ports.
+
+   Each tap keeps a window of the most recent (optionally decimated) frames
+   of a port, and publishes a copy every cycle through a triple buffer, so a
+   reader can fetch a coherent snapshot without locks, and the process thread
+   never allocates.
+*/
+
+#ifndef JALV_SCOPE_H
+#define JALV_SCOPE_H
+
+#include "attributes.h"
+
+#include <stdint.h>
+
+JALV_BEGIN_DECLS
+
+/// A snapshot of the recent signal of a port
+typedef struct {
+  uint64_t frame;    ///< Number of input frames before the end of the window
+  uint32_t n_frames; ///< Number of valid frames, which are at the end of data
+  uint32_t length;   ///< Total number of frames in data
+  float    data[];   ///< Oldest to newest decimated frames
+} JalvScopeSnapshot;
+
+typedef struct JalvScopeImpl JalvScope;
+
+/// Create a scope with no taps for a plugin with `n_ports` ports
+JalvScope*
+jalv_scope_new(uint32_t n_ports);
+
+/// Free a scope
+void
+jalv_scope_free(JalvScope* scope);
+
+/**
+   Add a tap to a port, which must be done before the scope is run.
+
+   @param scope The scope.
+   @param port_index Index of the audio or CV port to capture.
+   @param length Number of frames in the window, after decimation.
+   @param decimation Take one of every `decimation` frames, at least 1.
+   @return Zero on success.
+*/
+int
+jalv_scope_add_tap(JalvScope* scope,
+                   uint32_t   port_index,
+                   uint32_t   length,
+                   uint32_t   decimation);
+
+/// Return the number of taps
+uint32_t
+jalv_scope_n_taps(const JalvScope* scope);
+
+/// Return the index of the port captured by a tap
+uint32_t
+jalv_scope_port(const JalvScope* scope, uint32_t tap);
+
+/// Note the buffer connected to a plugin port (realtime safe)
+void
+jalv_scope_connect(JalvScope* scope, uint32_t port_index, const void* buf);
+
+/// Capture one cycle of audio after the plugin has run (realtime safe)
+void
+jalv_scope_run(JalvScope* scope, uint32_t n_frames);
+
+/**
+   Return the latest snapshot of a tap.
+
+   This never blocks, but must only be called from one thread.  The snapshot
+   stays valid and unchanged until the next read of the same tap.
+*/
+const JalvScopeSnapshot*
+jalv_scope_read(JalvScope* scope, uint32_t tap);
+
+JALV_END_DECLS
+
+#endif // JALV_SCOPE_H
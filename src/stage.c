@@ -0,0 +1,480 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+#include "stage.h"
+
+#include "atomic.h"
+#include "dsp.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Length of dry delay lines in frames (a power of two)
+#define JALV_STAGE_MAX_DELAY 32768U
+
+/// Number of frames processed at once, which limits stack usage
+#define JALV_STAGE_CHUNK 256U
+
+/// Time constant of parameter smoothing in seconds
+#define JALV_STAGE_SMOOTH_TIME 0.01f
+
+/// Duration of the bypass crossfade in seconds
+#define JALV_STAGE_BYPASS_TIME 0.02f
+
+typedef struct {
+  uint32_t output; ///< Index of wet output port
+  uint32_t input;  ///< Index of dry input port, or JALV_STAGE_NO_INPUT
+  float*   delay;  ///< Dry signal delay line
+} JalvStageChannel;
+
+struct JalvStageImpl {
+  float**           buffers;    ///< Buffer connected to each port
+  uint32_t          n_ports;    ///< Number of plugin ports
+  JalvStageChannel* channels;   ///< Channels to process
+  uint32_t          n_channels; ///< Number of channels
+  uint32_t*         outputs;    ///< Unmixed outputs to silence
+  uint32_t          n_outputs;  ///< Number of unmixed outputs
+  uint32_t          write_pos;  ///< Write position in delay lines
+  float             rate;       ///< Sample rate
+  float             wet;        ///< Current (smoothed) wet gain
+  float             gain;       ///< Current (smoothed) output gain
+  float             bypass;     ///< Current bypass from 0 (off) to 1 (on)
+  uint32_t          controls[JALV_STAGE_N_CONTROLS]; ///< Float bits (atomic)
+};
+
+JalvStage*
+jalv_stage_new(const uint32_t n_ports, const float sample_rate)
+{
+  JalvStage* const stage = (JalvStage*)calloc(1, sizeof(JalvStage));
+  if (!stage) {
+    return NULL;
+  }
+
+  if (!(stage->buffers = (float**)calloc(n_ports ? n_ports : 1U,
+                                         sizeof(float*)))) {
+    free(stage);
+    return NULL;
+  }
+
+  stage->n_ports = n_ports;
+  stage->rate    = sample_rate;
+  stage->wet     = NAN;
+  stage->gain    = NAN;
+  stage->bypass  = NAN;
+  jalv_stage_set_control(stage, JALV_STAGE_WET, 1.0f);
+  jalv_stage_set_control(stage, JALV_STAGE_GAIN, 0.0f);
+  return stage;
+}
+
+void
+jalv_stage_free(JalvStage* const stage)
+{
+  if (stage) {
+    for (uint32_t c = 0U; c < stage->n_channels; ++c) {
+      jalv_dsp_free(stage->channels[c].delay);
+    }
+
+    free(stage->outputs);
+    free(stage->channels);
+    free(stage->buffers);
+    free(stage);
+  }
+}
+
+int
+jalv_stage_add_channel(JalvStage* const stage,
+                       const uint32_t   output,
+                       const uint32_t   input)
+{
+  JalvStageChannel* const channels = (JalvStageChannel*)realloc(
+    stage->channels, (stage->n_channels + 1U) * sizeof(JalvStageChannel));
+  if (!channels) {
+    return 1;
+  }
+
+  stage->channels = channels;
+
+  JalvStageChannel* const channel = &channels[stage->n_channels];
+  channel->output                 = output;
+  channel->input                  = input;
+  channel->delay                  = NULL;
+  if (input != JALV_STAGE_NO_INPUT &&
+      !(channel->delay = jalv_dsp_alloc(JALV_STAGE_MAX_DELAY))) {
+    return 1;
+  }
+
+  ++stage->n_channels;
+  return 0;
+}
+
+int
+jalv_stage_add_output(JalvStage* const stage, const uint32_t output)
+{
+  uint32_t* const outputs = (uint32_t*)realloc(
+    stage->outputs, (stage->n_outputs + 1U) * sizeof(uint32_t));
+  if (!outputs) {
+    return 1;
+  }
+
+  stage->outputs                     = outputs;
+  stage->outputs[stage->n_outputs++] = output;
+  return 0;
+}
+
+uint32_t
+jalv_stage_n_channels(const JalvStage* const stage)
+{
+  return stage->n_channels;
+}
+
+float
+jalv_stage_control(const JalvStage* const stage, const JalvStageControl control)
+{
+  const uint32_t bits  = JALV_ATOMIC_LOAD(&stage->controls[control]);
+  float          value = 0.0f;
+
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+void
+jalv_stage_set_control(JalvStage* const       stage,
+                       const JalvStageControl control,
+                       const float            value)
+{
+  uint32_t bits = 0U;
+  memcpy(&bits, &value, sizeof(bits));
+  JALV_ATOMIC_STORE(&stage->controls[control], bits);
+}
+
+void
+jalv_stage_connect(JalvStage* const stage,
+                   const uint32_t   port_index,
+                   void* const      buf)
+{
+  if (port_index < stage->n_ports) {
+    stage->buffers[port_index] = (float*)buf;
+  }
+}
+
+/// Move `current` towards `target` for a cycle of `n_frames`
+static float
+jalv_stage_smooth(const JalvStage* const stage,
+                  const float            current,
+                  const float            target,
+                  const uint32_t         n_frames)
+{
+  if (isnan(current)) {
+    return target; // First cycle, start at the initial value
+  }
+
+  const float tau  = JALV_STAGE_SMOOTH_TIME * stage->rate;
+  const float k    = expf(-(float)n_frames / tau);
+  const float next = target + (current - target) * k;
+
+  return fabsf(next - target) < 1.0e-6f ? target : next;
+}
+
+/// Move the bypass amount linearly towards its target for a cycle
+static float
+jalv_stage_fade_bypass(const JalvStage* const stage,
+                       const float            current,
+                       const float            target,
+                       const uint32_t         n_frames)
+{
+  if (isnan(current)) {
+    return target;
+  }
+
+  const float step = (float)n_frames / (JALV_STAGE_BYPASS_TIME * stage->rate);
+
+  return target > current ? fminf(current + step, target)
+                          : fmaxf(current - step, target);
+}
+
+bool
+jalv_stage_bypassed(const JalvStage* const stage)
+{
+  return stage->bypass == 1.0f &&
+         jalv_stage_control(stage, JALV_STAGE_BYPASS) >= 0.5f;
+}
+
+/// Write a chunk of input to a delay line and read the delayed dry signal
+static void
+jalv_stage_delay(const JalvStage* const        stage,
+                 const JalvStageChannel* const channel,
+                 const float* const            input,
+                 float* const                  dry,
+                 const uint32_t                n_frames,
+                 const uint32_t                latency)
+{
+  static const uint32_t mask = JALV_STAGE_MAX_DELAY - 1U;
+
+  float* const   delay = channel->delay;
+  const uint32_t wpos  = stage->write_pos;
+  const uint32_t rpos  = (wpos - latency) & mask;
+
+  // Write input, wrapping around at the end of the delay line
+  const uint32_t w1 = n_frames < JALV_STAGE_MAX_DELAY - wpos
+                        ? n_frames
+                        : JALV_STAGE_MAX_DELAY - wpos;
+  if (input) {
+    memcpy(delay + wpos, input, w1 * sizeof(float));
+    memcpy(delay, input + w1, (n_frames - w1) * sizeof(float));
+  } else {
+    memset(delay + wpos, 0, w1 * sizeof(float));
+    memset(delay, 0, (n_frames - w1) * sizeof(float));
+  }
+
+  // Read the dry signal from `latency` frames earlier
+  const uint32_t r1 = n_frames < JALV_STAGE_MAX_DELAY - rpos
+                        ? n_frames
+                        : JALV_STAGE_MAX_DELAY - rpos;
+  memcpy(dry, delay + rpos, r1 * sizeof(float));
+  memcpy(dry + r1, delay, (n_frames - r1) * sizeof(float));
+}
+
+void
+jalv_stage_run(JalvStage* const stage,
+               const uint32_t   n_frames,
+               const uint32_t   latency,
+               const bool       plugin_ran)
+{
+  static const uint32_t mask = JALV_STAGE_MAX_DELAY - 1U;
+
+  if (!n_frames) {
+    return;
+  }
+
+  // Silence unmixed outputs which the plugin didn't write
+  for (uint32_t o = 0U; o < stage->n_outputs && !plugin_ran; ++o) {
+    float* const output = stage->buffers[stage->outputs[o]];
+    if (output) {
+      memset(output, 0, n_frames * sizeof(float));
+    }
+  }
+
+  // Determine the parameter ramps for this cycle
+  const float bypass      = jalv_stage_control(stage, JALV_STAGE_BYPASS);
+  const float gain_db     = jalv_stage_control(stage, JALV_STAGE_GAIN);
+  const float wet_target  = jalv_stage_control(stage, JALV_STAGE_WET);
+  const float gain_target = powf(10.0f, gain_db / 20.0f);
+  const float wet0        = isnan(stage->wet) ? wet_target : stage->wet;
+  const float gain0       = isnan(stage->gain) ? gain_target : stage->gain;
+  const float wet1 = jalv_stage_smooth(stage, stage->wet, wet_target, n_frames);
+  const float gain1 =
+    jalv_stage_smooth(stage, stage->gain, gain_target, n_frames);
+
+  // Bypass holds if the plugin didn't run, otherwise it fades linearly
+  const float bypass_target = !plugin_ran || bypass >= 0.5f ? 1.0f : 0.0f;
+  const float bypass0 = isnan(stage->bypass) ? bypass_target : stage->bypass;
+  const float bypass1 =
+    plugin_ran
+      ? jalv_stage_fade_bypass(stage, stage->bypass, bypass_target, n_frames)
+      : 1.0f;
+
+  const float wet_step    = (wet1 - wet0) / (float)n_frames;
+  const float gain_step   = (gain1 - gain0) / (float)n_frames;
+  const float bypass_step = (bypass1 - bypass0) / (float)n_frames;
+  const bool  unity = wet0 == 1.0f && wet1 == 1.0f && gain0 == 1.0f &&
+                     gain1 == 1.0f && bypass0 == 0.0f && bypass1 == 0.0f;
+
+  // The delay line must hold the latency and a chunk that is written first
+  const uint32_t delay = latency < JALV_STAGE_MAX_DELAY - JALV_STAGE_CHUNK
+                           ? latency
+                           : JALV_STAGE_MAX_DELAY - JALV_STAGE_CHUNK;
+
+  float dry[JALV_STAGE_CHUNK];
+  for (uint32_t offset = 0U; offset < n_frames; offset += JALV_STAGE_CHUNK) {
+    const uint32_t n = n_frames - offset < JALV_STAGE_CHUNK ? n_frames - offset
+                                                             : JALV_STAGE_CHUNK;
+
+    // The wet gain is the product of the mix and the inverse bypass amount
+    const float b0 = bypass0 + bypass_step * (float)offset;
+    const float b1 = bypass0 + bypass_step * (float)(offset + n);
+    const float w0 = (wet0 + wet_step * (float)offset) * (1.0f - b0);
+    const float w1 = (wet0 + wet_step * (float)(offset + n)) * (1.0f - b1);
+    const float g0 = gain0 + gain_step * (float)offset;
+    const float g1 = gain0 + gain_step * (float)(offset + n);
+
+    for (uint32_t c = 0U; c < stage->n_channels; ++c) {
+      const JalvStageChannel* const channel = &stage->channels[c];
+      float* const                  output  = stage->buffers[channel->output];
+      const float* const            input =
+        channel->input == JALV_STAGE_NO_INPUT ? NULL
+                                              : stage->buffers[channel->input];
+
+      if (channel->delay) {
+        jalv_stage_delay(
+          stage, channel, input ? input + offset : NULL, dry, n, delay);
+      }
+
+      if (output && !plugin_ran) {
+        // Replace output which the plugin didn't write with the dry signal
+        float* const out = output + offset;
+        if (channel->delay) {
+          jalv_dsp_crossfade(out, dry, NULL, n, g0, g1);
+        } else {
+          memset(out, 0, n * sizeof(float));
+        }
+      } else if (output && !unity) {
+        float* const out = output + offset;
+        jalv_dsp_crossfade(out, out, channel->delay ? dry : NULL, n, w0, w1);
+        jalv_dsp_crossfade(out, out, NULL, n, g0, g1);
+      }
+    }
+
+    stage->write_pos = (stage->write_pos + n) & mask;
+  }
+
+  stage->wet    = wet1;
+  stage->gain   = gain1;
+  stage->bypass = bypass1;
+}
+
+#ifdef STAGE_STANDALONE
+
+#  include <stdio.h>
+
+#  define TEST_PORTS 2U
+#  define TEST_BLOCK 300U
+#  define TEST_LATENCY 37U
+
+/// Run `n_blocks` cycles of a stage where the "plugin" outputs a constant
+static int
+run_stage(JalvStage* const stage,
+          float* const     input,
+          float* const     output,
+          const uint32_t   first,
+          const uint32_t   n_blocks,
+          const float      wet,
+          const float      expected_gain)
+{
+  for (uint32_t b = first; b < first + n_blocks; ++b) {
+    const bool run = !jalv_stage_bypassed(stage);
+    for (uint32_t i = 0U; i < TEST_BLOCK; ++i) {
+      input[i]  = (float)(b * TEST_BLOCK + i);
+      output[i] = run ? 1.0f : NAN;
+    }
+
+    jalv_stage_run(stage, TEST_BLOCK, TEST_LATENCY, run);
+
+    for (uint32_t i = 0U; i < TEST_BLOCK; ++i) {
+      const uint32_t t   = b * TEST_BLOCK + i;
+      const float    d   = t < TEST_LATENCY ? 0.0f : (float)(t - TEST_LATENCY);
+      const float    ref = (d + (1.0f - d) * wet) * expected_gain;
+      if (!(fabsf(output[i] - ref) <= 1.0e-3f * (1.0f + fabsf(ref)))) {
+        return fprintf(stderr,
+                       "error: Output %f at frame %u, expected %f\n",
+                       (double)output[i],
+                       t,
+                       (double)ref);
+      }
+    }
+  }
+
+  return 0;
+}
+
+static int
+test_stage(const float wet, const float gain_db, const float expected_gain)
+{
+  JalvStage* const stage = jalv_stage_new(TEST_PORTS, 48000.0f);
+  if (!stage || jalv_stage_add_channel(stage, 1U, 0U)) {
+    return fprintf(stderr, "error: Failed to create stage\n");
+  }
+
+  jalv_stage_set_control(stage, JALV_STAGE_WET, wet);
+  jalv_stage_set_control(stage, JALV_STAGE_GAIN, gain_db);
+
+  float input[TEST_BLOCK];
+  float output[TEST_BLOCK];
+  jalv_stage_connect(stage, 0U, input);
+  jalv_stage_connect(stage, 1U, output);
+
+  int st = run_stage(stage, input, output, 0U, 4U, wet, expected_gain);
+
+  // Bypassing should output the aligned dry signal without running the plugin
+  jalv_stage_set_control(stage, JALV_STAGE_BYPASS, 1.0f);
+  for (uint32_t b = 4U; b < 8U; ++b) {
+    const bool run = !jalv_stage_bypassed(stage);
+    for (uint32_t i = 0U; i < TEST_BLOCK; ++i) {
+      input[i]  = (float)(b * TEST_BLOCK + i);
+      output[i] = 1.0f;
+    }
+
+    jalv_stage_run(stage, TEST_BLOCK, TEST_LATENCY, run);
+  }
+
+  if (!st && !jalv_stage_bypassed(stage)) {
+    st = fprintf(stderr, "error: Stage not bypassed after crossfade\n");
+  }
+
+  st = st ? st : run_stage(stage, input, output, 8U, 2U, 0.0f, expected_gain);
+
+  // Enabling again should fade back to the plugin output
+  jalv_stage_set_control(stage, JALV_STAGE_BYPASS, 0.0f);
+  for (uint32_t b = 10U; b < 14U && !st; ++b) {
+    for (uint32_t i = 0U; i < TEST_BLOCK; ++i) {
+      input[i]  = (float)(b * TEST_BLOCK + i);
+      output[i] = 1.0f;
+    }
+
+    jalv_stage_run(stage, TEST_BLOCK, TEST_LATENCY, true);
+  }
+
+  st = st ? st : run_stage(stage, input, output, 14U, 2U, wet, expected_gain);
+
+  jalv_stage_free(stage);
+  return st;
+}
+
+static int
+test_outputs(void)
+{
+  JalvStage* const stage = jalv_stage_new(1U, 48000.0f);
+  if (!stage || jalv_stage_add_output(stage, 0U)) {
+    return fprintf(stderr, "error: Failed to create stage\n");
+  }
+
+  float output[TEST_BLOCK];
+  jalv_stage_connect(stage, 0U, output);
+
+  // Unmixed outputs should be left alone if the plugin ran, or silenced
+  int st = 0;
+  for (uint32_t b = 0U; b < 2U && !st; ++b) {
+    const bool run = !b;
+    for (uint32_t i = 0U; i < TEST_BLOCK; ++i) {
+      output[i] = 1.0f;
+    }
+
+    jalv_stage_run(stage, TEST_BLOCK, TEST_LATENCY, run);
+
+    for (uint32_t i = 0U; i < TEST_BLOCK && !st; ++i) {
+      if (output[i] != (run ? 1.0f : 0.0f)) {
+        st = fprintf(stderr,
+                     "error: Output %f at frame %u with run %d\n",
+                     (double)output[i],
+                     i,
+                     (int)run);
+      }
+    }
+  }
+
+  jalv_stage_free(stage);
+  return st;
+}
+
+int
+main(void)
+{
+  return test_outputs() || test_stage(0.0f, 0.0f, 1.0f) ||
+         test_stage(1.0f, 0.0f, 1.0f) || test_stage(0.25f, 0.0f, 1.0f) ||
+         test_stage(1.0f, -6.0206f, 0.5f) ||
+         test_stage(0.5f, 6.0206f, 2.0f);
+}
+
+#endif // STAGE_STANDALONE
@@ -0,0 +1,106 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+/**
+   @file stage.h Host output stage with bypass, dry/wet mix, and output gain.
+
+   The stage runs in the process thread after the plugin, and mixes each audio
+   output with the corresponding input, delayed by the plugin's latency so the
+   two are aligned.  Its parameters are pseudo-controls which are set like
+   plugin control ports, and smoothed per sample to avoid zipper noise.
+*/
+
+#ifndef JALV_STAGE_H
+#define JALV_STAGE_H
+
+#include "attributes.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+JALV_BEGIN_DECLS
+
+/// Index of an output stage control
+typedef enum {
+  JALV_STAGE_WET,        ///< Dry/wet mix from 0 (dry) to 1 (wet)
+  JALV_STAGE_GAIN,       ///< Output gain in dB
+  JALV_STAGE_BYPASS,     ///< Bypass plugin if 1, with a short crossfade
+  JALV_STAGE_N_CONTROLS, ///< Number of controls
+} JalvStageControl;
+
+/// Port index used for an output channel with no dry input
+#define JALV_STAGE_NO_INPUT UINT32_MAX
+
+typedef struct JalvStageImpl JalvStage;
+
+/// Create a new output stage for a plugin with `n_ports` ports
+JalvStage*
+jalv_stage_new(uint32_t n_ports, float sample_rate);
+
+/// Free an output stage
+void
+jalv_stage_free(JalvStage* stage);
+
+/**
+   Add a channel that mixes `input` into `output`.
+
+   `input` may be JALV_STAGE_NO_INPUT, in which case the dry signal is silent,
+   so the mix control only attenuates the output.  Not realtime safe.
+*/
+int
+jalv_stage_add_channel(JalvStage* stage, uint32_t output, uint32_t input);
+
+/**
+   Add an output that is not mixed, but is silenced when the plugin doesn't
+   run, so it doesn't repeat a stale buffer.  Not realtime safe.
+*/
+int
+jalv_stage_add_output(JalvStage* stage, uint32_t output);
+
+/// Return the number of channels in the stage
+uint32_t
+jalv_stage_n_channels(const JalvStage* stage);
+
+/// Return the value of a control
+float
+jalv_stage_control(const JalvStage* stage, JalvStageControl control);
+
+/**
+   Set the value of a control (realtime safe).
+
+   This is stored atomically, so it may be called from the UI thread, and is
+   read by the stage at the start of every cycle.
+*/
+void
+jalv_stage_set_control(JalvStage*       stage,
+                       JalvStageControl control,
+                       float            value);
+
+/// Note the buffer connected to a plugin port (realtime safe)
+void
+jalv_stage_connect(JalvStage* stage, uint32_t port_index, void* buf);
+
+/**
+   Return true if the plugin is completely bypassed.
+
+   This is true once the crossfade to bypass has finished, until bypass is
+   disabled, so the plugin doesn't need to be run in the meantime.
+*/
+bool
+jalv_stage_bypassed(const JalvStage* stage);
+
+/**
+   Process one cycle after the plugin (realtime safe).
+
+   If `plugin_ran` is false, then the plugin outputs are ignored and the
+   stage stays fully bypassed for this cycle, with unmixed outputs silenced.
+*/
+void
+jalv_stage_run(JalvStage* stage,
+               uint32_t   n_frames,
+               uint32_t   latency,
+               bool       plugin_ran);
+
+JALV_END_DECLS
+
+#endif // JALV_STAGE_H
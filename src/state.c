@@ -3,6 +3,8 @@
 
 #include "state.h"
 
+#include "clock.h"
+#include "command.h"
 #include "jalv_internal.h"
 #include "log.h"
 #include "nodes.h"
@@ -72,10 +74,38 @@ jalv_save(Jalv* jalv, const char* dir)
 
   lilv_state_free(state);
 
+  // Save modulators as commands, since they are host settings, not state
+  char* const path   = jalv_strjoin(dir, "/modulators.txt");
+  FILE* const stream = fopen(path, "w");
+  if (stream) {
+    jalv_write_modulators(jalv, stream);
+    fclose(stream);
+  } else {
+    jalv_log(JALV_LOG_ERR, "Failed to write %s\n", path);
+  }
+
+  free(path);
   free(jalv->save_dir);
   jalv->save_dir = NULL;
 }
 
+void
+jalv_load_modulators(Jalv* jalv, const char* dir)
+{
+  char* const path   = jalv_strjoin(dir, "/modulators.txt");
+  FILE* const stream = fopen(path, "r");
+  if (stream) {
+    char line[1024];
+    while (fgets(line, sizeof(line), stream)) {
+      jalv_process_host_command(jalv, line);
+    }
+
+    fclose(stream);
+  }
+
+  free(path);
+}
+
 int
 jalv_load_presets(Jalv* jalv, PresetSink sink, void* data)
 {
@@ -169,6 +199,7 @@ jalv_apply_state(Jalv* jalv, LilvState* state)
 {
   bool must_pause = !jalv->safe_restore && jalv->play_state == JALV_RUNNING;
   if (state) {
+    const uint64_t pause_start = jalv_clock_now();
     if (must_pause) {
       jalv->play_state = JALV_PAUSE_REQUESTED;
       zix_sem_wait(&jalv->paused);
@@ -190,6 +221,12 @@ jalv_apply_state(Jalv* jalv, LilvState* state)
     if (must_pause) {
       jalv->request_update = true;
       jalv->play_state     = JALV_RUNNING;
+
+      // Record how long the plugin was not running (including the fade out)
+      const uint64_t duration = jalv_clock_now() - pause_start;
+      ++jalv->n_pauses;
+      jalv->pause_last = duration;
+      jalv->pause_max = duration > jalv->pause_max ? duration : jalv->pause_max;
     }
   }
 }
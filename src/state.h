@@ -44,6 +44,10 @@ jalv_save_preset(Jalv*       jalv,
 void
 jalv_save(Jalv* jalv, const char* dir);
 
+/// Set up modulators saved with the state in a directory, if there are any
+void
+jalv_load_modulators(Jalv* jalv, const char* dir);
+
 void
 jalv_save_port_values(Jalv* jalv, SerdWriter* writer, const SerdNode* subject);
 
@@ -0,0 +1,86 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+#include "triple_buffer.h"
+
+#include "atomic.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+/// Flag set in the middle index when it holds an unread snapshot
+#define JALV_TRIPLE_FRESH 4
+
+struct JalvTripleBufferImpl {
+  void* slots[3]; ///< Snapshot buffers
+  int   middle;   ///< Shared slot index, and JALV_TRIPLE_FRESH if unread
+  int   back;     ///< Slot index owned by the writer
+  int   front;    ///< Slot index owned by the reader
+};
+
+JalvTripleBuffer*
+jalv_triple_buffer_new(const size_t size)
+{
+  JalvTripleBuffer* const buffer =
+    (JalvTripleBuffer*)calloc(1, sizeof(JalvTripleBuffer));
+
+  if (buffer) {
+    for (unsigned i = 0U; i < 3U; ++i) {
+      if (!(buffer->slots[i] = calloc(1, size ? size : 1U))) {
+        jalv_triple_buffer_free(buffer);
+        return NULL;
+      }
+    }
+
+    buffer->front  = 0;
+    buffer->middle = 1;
+    buffer->back   = 2;
+  }
+
+  return buffer;
+}
+
+void
+jalv_triple_buffer_free(JalvTripleBuffer* const buffer)
+{
+  if (buffer) {
+    for (unsigned i = 0U; i < 3U; ++i) {
+      free(buffer->slots[i]);
+    }
+
+    free(buffer);
+  }
+}
+
+void*
+jalv_triple_buffer_write_begin(JalvTripleBuffer* const buffer)
+{
+  return buffer->slots[buffer->back];
+}
+
+void
+jalv_triple_buffer_write_end(JalvTripleBuffer* const buffer)
+{
+  // Swap the written back slot with the middle, marking it unread
+  const int old =
+    JALV_ATOMIC_EXCHANGE(&buffer->middle, buffer->back | JALV_TRIPLE_FRESH);
+
+  buffer->back = old & 3;
+}
+
+const void*
+jalv_triple_buffer_read(JalvTripleBuffer* const buffer, bool* const fresh)
+{
+  const bool is_fresh = JALV_ATOMIC_LOAD(&buffer->middle) & JALV_TRIPLE_FRESH;
+  if (is_fresh) {
+    // Swap the unread middle slot with the front
+    buffer->front = JALV_ATOMIC_EXCHANGE(&buffer->middle, buffer->front) & 3;
+  }
+
+  if (fresh) {
+    *fresh = is_fresh;
+  }
+
+  return buffer->slots[buffer->front];
+}
@@ -0,0 +1,54 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+/**
+   @file triple_buffer.h A lock-free triple buffer for publishing snapshots.
+
+   This passes the latest value of some fixed-size data from one writer
+   thread to one reader thread.  Neither side ever blocks: the writer always
+   has a buffer to write into, and the reader always has a complete snapshot
+   to read, which is the most recently published one.  Intermediate snapshots
+   are dropped if the reader doesn't keep up.
+*/
+
+#ifndef JALV_TRIPLE_BUFFER_H
+#define JALV_TRIPLE_BUFFER_H
+
+#include "attributes.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+JALV_BEGIN_DECLS
+
+typedef struct JalvTripleBufferImpl JalvTripleBuffer;
+
+/// Create a new triple buffer with zeroed snapshots of `size` bytes
+JalvTripleBuffer*
+jalv_triple_buffer_new(size_t size);
+
+/// Free a triple buffer
+void
+jalv_triple_buffer_free(JalvTripleBuffer* buffer);
+
+/// Return the buffer for the writer to fill with the next snapshot
+void*
+jalv_triple_buffer_write_begin(JalvTripleBuffer* buffer);
+
+/// Publish the snapshot written since jalv_triple_buffer_write_begin()
+void
+jalv_triple_buffer_write_end(JalvTripleBuffer* buffer);
+
+/**
+   Return the latest published snapshot for the reader.
+
+   If `fresh` is not null, it is set to true if a new snapshot has been
+   published since the last read.  The returned snapshot stays valid and
+   unchanged until the next call.
+*/
+const void*
+jalv_triple_buffer_read(JalvTripleBuffer* buffer, bool* fresh);
+
+JALV_END_DECLS
+
+#endif // JALV_TRIPLE_BUFFER_H
@@ -20,6 +20,8 @@ typedef struct {
   LV2_URID bufsz_maxBlockLength;
   LV2_URID bufsz_minBlockLength;
   LV2_URID bufsz_sequenceSize;
+  LV2_URID jalv_ControlBatch;
+  LV2_URID jalv_EventSequence;
   LV2_URID log_Error;
   LV2_URID log_Trace;
   LV2_URID log_Warning;
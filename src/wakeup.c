@@ -0,0 +1,150 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+#include "wakeup.h"
+
+#include "atomic.h"
+#include "jalv_config.h"
+
+#if USE_PIPE
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+#include <stdlib.h>
+
+struct JalvWakeupImpl {
+  int fds[2];  ///< Read and write ends of a pipe
+  int pending; ///< Signalled since the last clear (atomic)
+};
+
+JalvWakeup*
+jalv_wakeup_new(void)
+{
+#if USE_PIPE
+  JalvWakeup* const wakeup = (JalvWakeup*)calloc(1, sizeof(JalvWakeup));
+  if (!wakeup) {
+    return NULL;
+  }
+
+  if (pipe(wakeup->fds)) {
+    free(wakeup);
+    return NULL;
+  }
+
+  // Neither end may block, so the process thread never waits on the UI
+  if (fcntl(wakeup->fds[0], F_SETFL, O_NONBLOCK) ||
+      fcntl(wakeup->fds[1], F_SETFL, O_NONBLOCK)) {
+    jalv_wakeup_free(wakeup);
+    return NULL;
+  }
+
+  return wakeup;
+#else
+  return NULL;
+#endif
+}
+
+void
+jalv_wakeup_free(JalvWakeup* const wakeup)
+{
+  if (wakeup) {
+#if USE_PIPE
+    close(wakeup->fds[0]);
+    close(wakeup->fds[1]);
+#endif
+    free(wakeup);
+  }
+}
+
+int
+jalv_wakeup_fd(const JalvWakeup* const wakeup)
+{
+  return wakeup->fds[0];
+}
+
+void
+jalv_wakeup_signal(JalvWakeup* const wakeup)
+{
+#if USE_PIPE
+  if (!JALV_ATOMIC_EXCHANGE(&wakeup->pending, 1)) {
+    const char byte = 0;
+    if (write(wakeup->fds[1], &byte, 1) != 1) {
+      JALV_ATOMIC_STORE(&wakeup->pending, 0); // Pipe is full, so already awake
+    }
+  }
+#else
+  (void)wakeup;
+#endif
+}
+
+void
+jalv_wakeup_clear(JalvWakeup* const wakeup)
+{
+#if USE_PIPE
+  JALV_ATOMIC_STORE(&wakeup->pending, 0);
+
+  char buf[16];
+  while (read(wakeup->fds[0], buf, sizeof(buf)) > 0) {
+  }
+#else
+  (void)wakeup;
+#endif
+}
+
+#ifdef WAKEUP_STANDALONE
+
+#  include <stdio.h>
+
+#  if USE_PIPE
+#    include <poll.h>
+
+/// Return true if the wakeup descriptor is readable
+static int
+is_readable(const JalvWakeup* const wakeup)
+{
+  struct pollfd pfd = {jalv_wakeup_fd(wakeup), POLLIN, 0};
+  return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+}
+
+int
+main(void)
+{
+  JalvWakeup* const wakeup = jalv_wakeup_new();
+  if (!wakeup) {
+    return fprintf(stderr, "error: Failed to create wakeup\n");
+  }
+
+  // Idle until signalled, then readable until cleared
+  int st = is_readable(wakeup);
+  for (unsigned i = 0U; i < 100U; ++i) {
+    jalv_wakeup_signal(wakeup);
+  }
+
+  st |= !is_readable(wakeup);
+  jalv_wakeup_clear(wakeup);
+  st |= is_readable(wakeup);
+
+  // Signals after a clear wake again
+  jalv_wakeup_signal(wakeup);
+  st |= !is_readable(wakeup);
+
+  jalv_wakeup_free(wakeup);
+  if (st) {
+    fprintf(stderr, "error: Unexpected wakeup state\n");
+  }
+
+  return st;
+}
+
+#  else
+
+int
+main(void)
+{
+  return jalv_wakeup_new() != NULL;
+}
+
+#  endif
+
+#endif // WAKEUP_STANDALONE
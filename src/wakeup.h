@@ -0,0 +1,53 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+/**
+   @file wakeup.h A file descriptor that wakes the UI thread.
+
+   The process thread signals this when it has sent something to the UI, so
+   the UI can wait on it in its main loop rather than polling on a timer.
+   Signals are coalesced, so there is at most one pending wakeup at a time.
+*/
+
+#ifndef JALV_WAKEUP_H
+#define JALV_WAKEUP_H
+
+#include "attributes.h"
+
+JALV_BEGIN_DECLS
+
+typedef struct JalvWakeupImpl JalvWakeup;
+
+/// Create a new wakeup, or return null if they aren't supported
+JalvWakeup*
+jalv_wakeup_new(void);
+
+/// Free a wakeup
+void
+jalv_wakeup_free(JalvWakeup* wakeup);
+
+/// Return a file descriptor that is readable while a wakeup is pending
+int
+jalv_wakeup_fd(const JalvWakeup* wakeup);
+
+/**
+   Wake the UI thread if it isn't already pending (realtime safe).
+
+   This only writes to the descriptor for the first signal since the last
+   clear, and is also safe to call from a signal handler.
+*/
+void
+jalv_wakeup_signal(JalvWakeup* wakeup);
+
+/**
+   Clear a pending wakeup.
+
+   This must be called before reading what was sent to the UI, so that any
+   later signal causes another wakeup.
+*/
+void
+jalv_wakeup_clear(JalvWakeup* wakeup);
+
+JALV_END_DECLS
+
+#endif // JALV_WAKEUP_H
@@ -0,0 +1,187 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+#include "watchdog.h"
+
+#include "atomic.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// Maximum back-off as a multiple of the initial back-off
+#define JALV_WATCHDOG_MAX_BACKOFF 64U
+
+struct JalvWatchdogImpl {
+  float    threshold;    ///< Fraction of the period that is an overrun
+  uint32_t trip_cycles;  ///< Number of consecutive overruns that trip
+  uint64_t min_backoff;  ///< Initial back-off time
+  uint32_t overruns;     ///< Current number of consecutive overruns
+  uint64_t resume_time;  ///< Clock time to resume a tripped plugin
+  uint64_t resumed_time; ///< Clock time the plugin last resumed, or 0
+  uint64_t backoff;      ///< Current back-off time
+  uint64_t last_trip;    ///< Clock time of the last trip, or 0
+  uint64_t last_run;     ///< Duration of the last run
+  int      n_trips;      ///< Number of trips (atomic)
+  int      tripped;      ///< Plugin is bypassed (atomic)
+};
+
+JalvWatchdog*
+jalv_watchdog_new(const float    threshold,
+                  const uint32_t trip_cycles,
+                  const double   backoff)
+{
+  JalvWatchdog* const watchdog =
+    (JalvWatchdog*)calloc(1, sizeof(JalvWatchdog));
+  if (watchdog) {
+    watchdog->threshold   = threshold;
+    watchdog->trip_cycles = trip_cycles ? trip_cycles : 1U;
+    watchdog->min_backoff = (uint64_t)(backoff * 1.0e9);
+    watchdog->backoff     = watchdog->min_backoff;
+  }
+
+  return watchdog;
+}
+
+void
+jalv_watchdog_free(JalvWatchdog* const watchdog)
+{
+  free(watchdog);
+}
+
+bool
+jalv_watchdog_ready(JalvWatchdog* const watchdog, const uint64_t now)
+{
+  if (!JALV_ATOMIC_LOAD(&watchdog->tripped)) {
+    return true;
+  }
+
+  if (now < watchdog->resume_time) {
+    return false;
+  }
+
+  watchdog->overruns     = 0U;
+  watchdog->resumed_time = now;
+  JALV_ATOMIC_STORE(&watchdog->tripped, 0);
+  return true;
+}
+
+bool
+jalv_watchdog_record(JalvWatchdog* const watchdog,
+                     const uint64_t      start,
+                     const uint64_t      end,
+                     const uint64_t      period)
+{
+  const uint64_t run_time = end - start;
+
+  watchdog->last_run = run_time;
+  if ((double)run_time <= (double)watchdog->threshold * (double)period) {
+    watchdog->overruns = 0U;
+    return false;
+  }
+
+  if (++watchdog->overruns < watchdog->trip_cycles) {
+    return false;
+  }
+
+  // Back off for longer if the plugin trips again soon after resuming
+  const uint64_t max_backoff =
+    watchdog->min_backoff * JALV_WATCHDOG_MAX_BACKOFF;
+  if (watchdog->resumed_time &&
+      end - watchdog->resumed_time < watchdog->backoff) {
+    watchdog->backoff = watchdog->backoff * 2U < max_backoff
+                          ? watchdog->backoff * 2U
+                          : max_backoff;
+  } else {
+    watchdog->backoff = watchdog->min_backoff;
+  }
+
+  watchdog->resume_time = end + watchdog->backoff;
+  watchdog->last_trip   = end;
+  JALV_ATOMIC_ADD(&watchdog->n_trips, 1);
+  JALV_ATOMIC_STORE(&watchdog->tripped, 1);
+  return true;
+}
+
+void
+jalv_watchdog_status(const JalvWatchdog* const watchdog,
+                     JalvWatchdogStatus* const status)
+{
+  status->threshold   = watchdog->threshold;
+  status->trip_cycles = watchdog->trip_cycles;
+  status->n_trips     = (uint32_t)JALV_ATOMIC_LOAD(&watchdog->n_trips);
+  status->tripped     = JALV_ATOMIC_LOAD(&watchdog->tripped);
+  status->backoff     = watchdog->backoff;
+  status->last_trip   = watchdog->last_trip;
+  status->last_run    = watchdog->last_run;
+}
+
+#ifdef WATCHDOG_STANDALONE
+
+#  include <stdio.h>
+
+#  define PERIOD 1000000U ///< 1 ms period
+
+/// Run cycles taking `run_time` each from `*now`, and return the trip count
+static uint32_t
+run_cycles(JalvWatchdog* const watchdog,
+           uint64_t* const     now,
+           const uint32_t      n_cycles,
+           const uint64_t      run_time)
+{
+  uint32_t n_trips = 0U;
+  for (uint32_t i = 0U; i < n_cycles; ++i) {
+    if (jalv_watchdog_ready(watchdog, *now)) {
+      n_trips += jalv_watchdog_record(watchdog, *now, *now + run_time, PERIOD);
+    }
+
+    *now += PERIOD;
+  }
+
+  return n_trips;
+}
+
+int
+main(void)
+{
+  // Trip after 3 overruns of 90% of the period, and back off for 10 ms
+  JalvWatchdog* const watchdog = jalv_watchdog_new(0.9f, 3U, 0.01);
+  JalvWatchdogStatus  status;
+  uint64_t            now = PERIOD;
+  int                 st  = 0;
+
+  // Occasional overruns don't trip
+  for (uint32_t i = 0U; i < 10U; ++i) {
+    st |= run_cycles(watchdog, &now, 2U, PERIOD) != 0U;
+    st |= run_cycles(watchdog, &now, 1U, PERIOD / 2U) != 0U;
+  }
+
+  // Consecutive overruns trip, and the plugin isn't run until the back-off
+  st |= run_cycles(watchdog, &now, 3U, PERIOD) != 1U;
+  st |= jalv_watchdog_ready(watchdog, now + 8U * PERIOD);
+  jalv_watchdog_status(watchdog, &status);
+  st |= !status.tripped || status.n_trips != 1U || status.backoff != 10000000U;
+
+  // Tripping again soon after resuming doubles the back-off
+  st |= run_cycles(watchdog, &now, 13U, PERIOD) != 1U;
+  jalv_watchdog_status(watchdog, &status);
+  st |= !status.tripped || status.n_trips != 2U || status.backoff != 20000000U;
+
+  // Running cleanly for a while resets the back-off
+  st |= run_cycles(watchdog, &now, 25U, PERIOD / 2U) != 0U;
+  jalv_watchdog_status(watchdog, &status);
+  st |= status.tripped;
+  st |= run_cycles(watchdog, &now, 20U, PERIOD / 2U) != 0U;
+  st |= run_cycles(watchdog, &now, 3U, PERIOD) != 1U;
+  jalv_watchdog_status(watchdog, &status);
+  st |= status.n_trips != 3U || status.backoff != 10000000U;
+
+  jalv_watchdog_free(watchdog);
+  if (st) {
+    fprintf(stderr, "error: Unexpected watchdog state\n");
+  }
+
+  return st;
+}
+
+#endif // WATCHDOG_STANDALONE
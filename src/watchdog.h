@@ -0,0 +1,89 @@
+// Copyright 2026 David Robillard <d@drobilla.net>
+// SPDX-License-Identifier: ISC
+
+/**
+   @file watchdog.h Watchdog that bypasses a plugin which overruns the period.
+
+   The process thread times every run of the plugin.  If it takes longer than
+   a fraction of the period for several consecutive cycles, the watchdog trips
+   and the plugin is not run (so its outputs are bypassed) until a back-off
+   time has passed.  The back-off doubles if the plugin trips again soon after
+   recovering, and is reset once it has run cleanly for a while.
+*/
+
+#ifndef JALV_WATCHDOG_H
+#define JALV_WATCHDOG_H
+
+#include "attributes.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+JALV_BEGIN_DECLS
+
+/// Configuration and current state of a watchdog
+typedef struct {
+  float    threshold;   ///< Fraction of the period that is an overrun
+  uint32_t trip_cycles; ///< Number of consecutive overruns that trip
+  uint64_t backoff;     ///< Current back-off time in nanoseconds
+  uint32_t n_trips;     ///< Number of times the watchdog has tripped
+  uint64_t last_trip;   ///< Clock time of the last trip, or 0
+  uint64_t last_run;    ///< Duration of the last plugin run in nanoseconds
+  bool     tripped;     ///< True if the plugin is currently bypassed
+} JalvWatchdogStatus;
+
+typedef struct JalvWatchdogImpl JalvWatchdog;
+
+/**
+   Create a new watchdog.
+
+   @param threshold Fraction of the period a run may take, like 0.9.
+   @param trip_cycles Number of consecutive overruns that trip the watchdog.
+   @param backoff Initial time to bypass the plugin when tripped, in seconds.
+*/
+JalvWatchdog*
+jalv_watchdog_new(float threshold, uint32_t trip_cycles, double backoff);
+
+/// Free a watchdog
+void
+jalv_watchdog_free(JalvWatchdog* watchdog);
+
+/**
+   Return true if the plugin may be run this cycle (realtime safe).
+
+   This resumes a tripped plugin once its back-off time has passed.
+
+   @param watchdog The watchdog.
+   @param now Current clock time in nanoseconds, from jalv_clock_now().
+*/
+bool
+jalv_watchdog_ready(JalvWatchdog* watchdog, uint64_t now);
+
+/**
+   Record a run of the plugin, and trip if it overran too often (realtime safe).
+
+   @param watchdog The watchdog.
+   @param start Clock time before running the plugin.
+   @param end Clock time after running the plugin.
+   @param period Duration of the cycle in nanoseconds.
+   @return True if the watchdog just tripped.
+*/
+bool
+jalv_watchdog_record(JalvWatchdog* watchdog,
+                     uint64_t      start,
+                     uint64_t      end,
+                     uint64_t      period);
+
+/**
+   Get the current status of a watchdog.
+
+   This may be called from any thread.  Since the process thread doesn't wait
+   for readers, the fields may be slightly inconsistent if the watchdog trips
+   or recovers during the call.
+*/
+void
+jalv_watchdog_status(const JalvWatchdog* watchdog, JalvWatchdogStatus* status);
+
+JALV_END_DECLS
+
+#endif // JALV_WATCHDOG_H